@@ -0,0 +1,199 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Hashing.h"
+
+#ifndef LEARNING_BLOCKEDBLOOMFILTER_H
+#define LEARNING_BLOCKEDBLOOMFILTER_H
+
+
+/**
+ * @brief A cache-line-blocked Bloom filter over 64-bit hashes.
+ *
+ * The filter is an array of 64-byte blocks. A hash picks one block with its high half, and
+ * its low half sets one bit in each of the 8 words of that block (a split block Bloom filter).
+ * A query therefore touches exactly one cache line. The 8 bit positions come from 8 independent
+ * multiplies with fixed odd salts, a loop that compilers turn into SIMD code.
+ *
+ * Keys cannot be removed: a filter only says "maybe present" or "surely absent", and its
+ * owner rebuilds it when too many removed keys have piled up.
+ */
+class BlockedBloomFilter {
+protected:
+    static const int WORDS = 8;          /**< 64-bit words per block, one bit is set in each. */
+
+    /**
+     * @brief One cache line of the filter.
+     */
+    struct alignas(64) Block {
+        uint64_t words[WORDS];           /**< The bits of the block. */
+    };
+
+    Block* blocks;                       /**< The blocks, nullptr while the filter is empty. */
+    std::size_t block_count;             /**< The number of blocks. */
+    int bits_per_key;                    /**< Filter bits reserved per expected key. */
+
+    /**
+     * @brief Odd multipliers that turn the low half of a hash into 8 bit positions.
+     */
+    static const uint32_t* salts(){
+        static const uint32_t values[WORDS] = {
+                0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+        return values;
+    }
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param expected_keys The number of keys the filter is sized for, 0 for an empty filter.
+     * @param bits The number of filter bits per key. 10 bits give roughly a 1% false positive rate.
+     */
+    explicit BlockedBloomFilter(std::size_t expected_keys = 0, int bits = 10)
+            : blocks(nullptr), block_count(0), bits_per_key(bits < 1 ? 1 : bits) {
+        resize(expected_keys);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~BlockedBloomFilter(){
+        delete[] blocks;
+    }
+
+    /**
+     * @brief Move constructor. other is left empty.
+     *
+     * @param other The filter to move from.
+     */
+    BlockedBloomFilter(BlockedBloomFilter&& other) noexcept
+            : blocks(other.blocks), block_count(other.block_count), bits_per_key(other.bits_per_key) {
+        other.blocks = nullptr;
+        other.block_count = 0;
+    }
+
+    /**
+     * @brief Move assignment. Frees this filter and takes over the blocks of other, which is left empty.
+     *
+     * @param other The filter to move from.
+     * @return BlockedBloomFilter& This filter.
+     */
+    BlockedBloomFilter& operator=(BlockedBloomFilter&& other) noexcept {
+        if (&other == this) return *this;
+        delete[] blocks;
+        blocks = other.blocks;
+        block_count = other.block_count;
+        bits_per_key = other.bits_per_key;
+        other.blocks = nullptr;
+        other.block_count = 0;
+        return *this;
+    }
+
+    BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+    BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+    /**
+     * @brief Resizes the filter for a number of keys and clears it.
+     *
+     * @param expected_keys The number of keys the filter is sized for, 0 frees the filter.
+     */
+    void resize(std::size_t expected_keys){
+        delete[] blocks;
+        blocks = nullptr;
+        block_count = 0;
+        if (expected_keys == 0) return;
+        block_count = (expected_keys * bits_per_key + 511) / 512;
+        blocks = new Block[block_count];
+        clear();
+    }
+
+    /**
+     * @brief Removes all keys, keeping the size.
+     */
+    void clear(){
+        if (blocks != nullptr) std::memset(static_cast<void*>(blocks), 0, block_count * sizeof(Block));
+    }
+
+    /**
+     * @brief Sets the number of filter bits per key, used from the next resize on.
+     *
+     * @param bits The number of bits per key, at least 1.
+     */
+    void set_bits_per_key(int bits){
+        bits_per_key = bits < 1 ? 1 : bits;
+    }
+
+    /**
+     * @brief Adds a hash to the filter. Does nothing while the filter is empty.
+     *
+     * @param hash The hash of the key.
+     */
+    void insert(uint64_t hash){
+        if (blocks == nullptr) return;
+        uint64_t h = mix64(hash);
+        Block& block = blocks[block_of(h)];
+        uint32_t lane = static_cast<uint32_t>(h);
+        const uint32_t* salt = salts();
+        for (int i = 0; i < WORDS; i++) block.words[i] |= 1ULL << ((lane * salt[i]) >> 26);
+    }
+
+    /**
+     * @brief Checks if a hash may have been added.
+     *
+     * @param hash The hash of the key.
+     * @return true If the hash may be present, always true while the filter is empty.
+     * @return false If it was surely never added.
+     */
+    bool may_contain(uint64_t hash) const {
+        if (blocks == nullptr) return true;
+        uint64_t h = mix64(hash);
+        const Block& block = blocks[block_of(h)];
+        uint32_t lane = static_cast<uint32_t>(h);
+        const uint32_t* salt = salts();
+        // no early exit, so the 8 probes stay branch-free
+        uint64_t all = 1;
+        for (int i = 0; i < WORDS; i++) all &= block.words[i] >> ((lane * salt[i]) >> 26);
+        return all & 1;
+    }
+
+    /**
+     * @brief Checks if the filter has any blocks.
+     *
+     * @return true If the filter is sized for at least one key.
+     */
+    [[nodiscard]] bool is_active() const {
+        return blocks != nullptr;
+    }
+
+    /**
+     * @brief Retrieves the number of filter bits per key.
+     *
+     * @return int The number of bits per key.
+     */
+    [[nodiscard]] int get_bits_per_key() const {
+        return bits_per_key;
+    }
+
+    /**
+     * @brief Retrieves the size of the filter.
+     *
+     * @return std::size_t The number of bytes used by the blocks.
+     */
+    [[nodiscard]] std::size_t memory_size() const {
+        return block_count * sizeof(Block);
+    }
+
+
+protected:
+    /**
+     * @brief Picks the block of a mixed hash from its high half, without a division.
+     */
+    std::size_t block_of(uint64_t mixed) const {
+        return static_cast<std::size_t>(((mixed >> 32) * static_cast<uint64_t>(block_count)) >> 32);
+    }
+}; // End of the class
+
+#endif //LEARNING_BLOCKEDBLOOMFILTER_H
@@ -0,0 +1,339 @@
+#include <shared_mutex>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "HashDict.h"
+#include "HashPolicy.h"
+#include "Hashing.h"
+
+#ifndef LEARNING_CONCURRENTHASHDICT_H
+#define LEARNING_CONCURRENTHASHDICT_H
+
+
+/**
+ * @brief One segment of a ConcurrentHashDict: a HashDict with its own reader-writer lock.
+ *
+ * Aligned to a cache line, so that the locks of neighbouring segments never share one.
+ *
+ * @tparam key_t The type of the keys.
+ * @tparam value_t The type of the values.
+ * @tparam Hash The hash functor.
+ * @tparam KeyEqual The key comparison functor.
+ */
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+struct alignas(64) ConcurrentSegment {
+    mutable std::shared_mutex lock;                    /**< Shared for readers, exclusive for writers. */
+    HashDict<key_t, value_t, Hash, KeyEqual> dict;     /**< The keys of this segment. */
+
+    /**
+     * @brief Constructor.
+     *
+     * @param hash The hash functor of the segment's HashDict.
+     * @param equal The key comparison functor of the segment's HashDict.
+     */
+    ConcurrentSegment(const Hash& hash, const KeyEqual& equal) : dict(hash, equal) {}
+};
+
+
+/**
+ * @brief A thread-safe dictionary built from lock-striped HashDict segments.
+ *
+ * A key's hash picks one of segment_count segments, and every segment is an ordinary HashDict
+ * guarded by its own std::shared_mutex. Lookups take the lock of one segment in shared mode,
+ * so readers never block each other. Writers lock one segment exclusively and only contend
+ * with threads that touch the same segment. A segment resizes under its own exclusive lock,
+ * so a resize never stops the rest of the table and needs no extra coordination.
+ *
+ * Values are handed out by copy (try_get) or inside a callback (update, for_each), never as
+ * references, because a reference would outlive the lock that protects it.
+ *
+ * @tparam key_t The type of keys stored in the ConcurrentHashDict.
+ * @tparam value_t The type of values associated with the keys.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, std::equal_to<key_t> by default.
+ */
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
+class ConcurrentHashDict {
+protected:
+    int segment_count;                                            /**< The number of segments, a power of two. */
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>* segments;  /**< Array of segments. */
+
+    Hash hasher;                                                  /**< The hash functor used to pick a segment. */
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * More segments mean less contention and more memory. Several segments per core is a good start.
+     *
+     * @param segments_number The number of segments, rounded up to a power of two. Defaults to 64.
+     * @param hash The hash functor to use, both to pick a segment and inside every segment.
+     * @param equal The key comparison functor to use.
+     * @throws std::logic_error If segments_number is not positive.
+     */
+    explicit ConcurrentHashDict(int segments_number = 64, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Destructor.
+     *
+     * Must not run while other threads still use the dictionary.
+     */
+    ~ConcurrentHashDict(){
+        destroy_segments(segment_count);
+    }
+
+    ConcurrentHashDict(const ConcurrentHashDict&) = delete;
+    ConcurrentHashDict& operator=(const ConcurrentHashDict&) = delete;
+
+    /**
+     * @brief Adds a key-value pair to the ConcurrentHashDict.
+     *
+     * Does nothing if the key is already present.
+     *
+     * @param key The key to be added.
+     * @param value The value associated with the key.
+     * @return true If the pair was inserted.
+     * @return false If the key was already present.
+     */
+    template<typename K, typename V>
+    bool add(K&& key, V&& value);
+
+    /**
+     * @brief Inserts a key-value pair, or assigns the value if the key is already present.
+     *
+     * @param key The key.
+     * @param value The value to insert or assign.
+     * @return true If the pair was inserted.
+     * @return false If an existing value was assigned.
+     */
+    template<typename V>
+    bool insert_or_assign(const key_t& key, V&& value);
+
+    /**
+     * @brief Removes a key-value pair from the ConcurrentHashDict.
+     *
+     * @param key The key to be removed.
+     * @throws std::logic_error If the key is not found.
+     */
+    void pop(const key_t& key);
+
+    /**
+     * @brief Removes a key-value pair if the key is present.
+     *
+     * @param key The key to be removed.
+     * @return true If the key was found and removed.
+     * @return false If the key was not present.
+     */
+    bool erase(const key_t& key);
+
+    /**
+     * @brief Checks if a key exists in the ConcurrentHashDict.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false Otherwise.
+     */
+    bool is_in(const key_t& key) const;
+
+    /**
+     * @brief Retrieves a copy of the value associated with a key, if there is one.
+     *
+     * @param key The key to look for.
+     * @return std::optional<value_t> The value, or std::nullopt if the key is not present.
+     */
+    std::optional<value_t> try_get(const key_t& key) const;
+
+    /**
+     * @brief Runs a function on the value of a key while its segment is locked exclusively.
+     *
+     * This is the way to read-modify-write a value atomically.
+     *
+     * Example:
+     * @code
+     * counters.update("requests", [](int& count){ count++; });
+     * @endcode
+     *
+     * @param key The key to look for.
+     * @param function Called as function(value_t&) if the key is present.
+     * @return true If the key was found.
+     * @return false Otherwise.
+     */
+    template<typename F>
+    bool update(const key_t& key, F&& function);
+
+    /**
+     * @brief Runs a function on every key-value pair, one segment at a time.
+     *
+     * Each segment is locked in shared mode while it is visited, so the scan does not see a
+     * single snapshot of the whole table. The function must not call back into this dictionary.
+     *
+     * @param function Called as function(const key_t&, const value_t&).
+     */
+    template<typename F>
+    void for_each(F&& function) const;
+
+    /**
+     * @brief Presizes every segment for an even share of count elements.
+     *
+     * @param count The total number of elements the dictionary should hold.
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Retrieves the number of key-value pairs in the ConcurrentHashDict.
+     *
+     * Segments are counted one after another, so under concurrent writes the result is only
+     * a close estimate.
+     *
+     * @return int The count of elements.
+     */
+    [[nodiscard]] int getSize() const;
+
+    /**
+     * @brief Retrieves the number of segments.
+     *
+     * @return int The number of segments.
+     */
+    [[nodiscard]] int get_segment_count() const {
+        return segment_count;
+    }
+
+
+protected:
+    /**
+     * @brief Picks the segment of a key.
+     *
+     * Uses the multiplicative mapping of POWER_OF_TWO tables, which takes the top bits of the
+     * mixed hash. The HashDict inside the segment reduces the hash on its own, so the keys of
+     * one segment still spread over all of its buckets.
+     *
+     * @param key The key.
+     * @return ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& The segment of the key.
+     */
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment_of(const key_t& key) const {
+        return segments[map_to_bucket(hasher(key), segment_count, SizingMode::POWER_OF_TWO)];
+    }
+
+    /**
+     * @brief Destroys the first count segments and frees the segment array.
+     *
+     * @param count The number of segments constructed so far.
+     */
+    void destroy_segments(int count){
+        for (int i = count - 1; i >= 0; i--) segments[i].~ConcurrentSegment();
+        ::operator delete(segments, std::align_val_t(alignof(ConcurrentSegment<key_t, value_t, Hash, KeyEqual>)));
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::ConcurrentHashDict(int segments_number, const Hash& hash, const KeyEqual& equal) : hasher(hash) {
+    if (segments_number <= 0) throw std::logic_error("segment count must be positive!!!");
+    segment_count = 1;
+    while (segment_count < segments_number) segment_count *= 2;
+
+    // built one by one, so that every segment gets the functors
+    using Segment = ConcurrentSegment<key_t, value_t, Hash, KeyEqual>;
+    segments = static_cast<Segment*>(::operator new(segment_count * sizeof(Segment), std::align_val_t(alignof(Segment))));
+    int built = 0;
+    try {
+        for (; built < segment_count; built++) new (&segments[built]) Segment(hash, equal);
+    } catch (...) {
+        ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::destroy_segments(built);
+        throw;
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename K, typename V>
+bool ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::add(K&& key, V&& value){
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::unique_lock<std::shared_mutex> guard(segment.lock);
+    return segment.dict.emplace(std::forward<K>(key), std::forward<V>(value)).second;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename V>
+bool ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::insert_or_assign(const key_t& key, V&& value){
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::unique_lock<std::shared_mutex> guard(segment.lock);
+    return segment.dict.insert_or_assign(key, std::forward<V>(value)).second;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::pop(const key_t& key){
+    if (!erase(key)) throw std::logic_error("no such key in the dict!!!");
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::erase(const key_t& key){
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::unique_lock<std::shared_mutex> guard(segment.lock);
+    return segment.dict.erase(key);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::is_in(const key_t& key) const{
+    const ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::shared_lock<std::shared_mutex> guard(segment.lock);
+    // the const find of HashDict changes nothing, so shared readers are safe
+    const HashDict<key_t, value_t, Hash, KeyEqual>& dict = segment.dict;
+    return dict.find(key) != nullptr;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::optional<value_t> ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::try_get(const key_t& key) const{
+    const ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::shared_lock<std::shared_mutex> guard(segment.lock);
+    return segment.dict.try_get(key);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename F>
+bool ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::update(const key_t& key, F&& function){
+    ConcurrentSegment<key_t, value_t, Hash, KeyEqual>& segment = segment_of(key);
+    std::unique_lock<std::shared_mutex> guard(segment.lock);
+    value_t* value = segment.dict.find(key);
+    if (value == nullptr) return false;
+    function(*value);
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename F>
+void ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::for_each(F&& function) const{
+    for (int i = 0; i < segment_count; i++){
+        std::shared_lock<std::shared_mutex> guard(segments[i].lock);
+        const HashDict<key_t, value_t, Hash, KeyEqual>& dict = segments[i].dict;
+        for (auto entry : dict) function(entry.key, entry.value);
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::reserve(int count){
+    int share = count / segment_count + 1;
+    for (int i = 0; i < segment_count; i++){
+        std::unique_lock<std::shared_mutex> guard(segments[i].lock);
+        segments[i].dict.reserve(share);
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+int ConcurrentHashDict<key_t, value_t, Hash, KeyEqual>::getSize() const{
+    int total = 0;
+    for (int i = 0; i < segment_count; i++){
+        std::shared_lock<std::shared_mutex> guard(segments[i].lock);
+        total += segments[i].dict.getSize();
+    }
+    return total;
+}
+
+#endif //LEARNING_CONCURRENTHASHDICT_H
@@ -0,0 +1,248 @@
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#ifndef LEARNING_EPOCHMANAGER_H
+#define LEARNING_EPOCHMANAGER_H
+
+
+/**
+ * @brief The largest number of threads that can be inside an EpochManager at the same time.
+ */
+const int EPOCH_MAX_THREADS = 256;
+
+
+/**
+ * @brief Gives every running thread a small index, unique among the running threads.
+ *
+ * The index is taken the first time a thread asks for it and returned when the thread exits,
+ * so a later thread may reuse it. Every EpochManager keeps one slot per index.
+ *
+ * @return int The index of the calling thread, in [0, EPOCH_MAX_THREADS).
+ * @throws std::logic_error If EPOCH_MAX_THREADS threads already hold an index.
+ */
+inline int epoch_thread_index(){
+    struct Registry {
+        std::mutex lock;
+        std::vector<int> free_indices;
+        int next_index = 0;
+    };
+    static Registry registry;
+
+    struct Holder {
+        int index;
+        Holder(){
+            std::lock_guard<std::mutex> guard(registry.lock);
+            if (!registry.free_indices.empty()){
+                index = registry.free_indices.back();
+                registry.free_indices.pop_back();
+            } else {
+                if (registry.next_index == EPOCH_MAX_THREADS) throw std::logic_error("too many threads for the epoch manager!!!");
+                index = registry.next_index++;
+            }
+        }
+        ~Holder(){
+            std::lock_guard<std::mutex> guard(registry.lock);
+            registry.free_indices.push_back(index);
+        }
+    };
+    thread_local Holder holder;
+    return holder.index;
+}
+
+
+/**
+ * @brief Epoch-based memory reclamation for structures with lock-free readers.
+ *
+ * A reader pins the manager for the duration of one operation. A writer that unlinks an
+ * object hands it to retire() instead of deleting it. The object is stamped with the current
+ * global epoch, and the epoch is advanced. The object is deleted once every pinned reader
+ * has pinned at a later epoch: such a reader started after the unlink and cannot hold a
+ * pointer to the object.
+ *
+ * Pinning costs one load, one store and one fence on a slot owned by the calling thread, so
+ * readers never write to shared cache lines and never wait for anyone.
+ *
+ * Example:
+ * @code
+ * {
+ *     EpochManager::Guard guard = epochs.pin();
+ *     // read shared pointers here
+ * } // unpinned
+ * @endcode
+ */
+class EpochManager {
+protected:
+    static const uint64_t IDLE = UINT64_MAX;       /**< The epoch of a slot whose thread is not pinned. */
+    static const std::size_t RECLAIM_BATCH = 64;   /**< Reclaiming is tried every this many retired objects. */
+
+    /**
+     * @brief The announced epoch of one thread, on its own cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{IDLE};   /**< The epoch the thread pinned at, IDLE if it is not pinned. */
+        int depth = 0;                       /**< Nesting depth of pins, only touched by the owning thread. */
+    };
+
+    /**
+     * @brief An unlinked object waiting to be deleted.
+     */
+    struct Retired {
+        uint64_t epoch;                  /**< The global epoch when the object was retired. */
+        void* object;                    /**< The object. */
+        void (*deleter)(void*);          /**< Deletes the object. */
+    };
+
+    std::atomic<uint64_t> global_epoch;  /**< The current epoch. */
+    Slot* slots;                         /**< One slot per thread index. */
+
+    std::mutex retired_lock;             /**< Guards retired. */
+    std::vector<Retired> retired;        /**< Objects waiting to be deleted, in retirement order. */
+
+public:
+    /**
+     * @brief Unpins the manager when it goes out of scope.
+     */
+    class Guard {
+    private:
+        EpochManager* manager;    /**< The pinned manager, nullptr once moved from. */
+        Slot* slot;               /**< The slot of the pinning thread. */
+
+        friend class EpochManager;
+
+        Guard(EpochManager* owner, Slot* thread_slot) : manager(owner), slot(thread_slot) {}
+
+    public:
+        Guard(Guard&& other) noexcept : manager(other.manager), slot(other.slot) {
+            other.manager = nullptr;
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard(){
+            if (manager == nullptr) return;
+            if (--slot->depth == 0) slot->epoch.store(IDLE, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Default constructor.
+     */
+    EpochManager() : global_epoch(0) {
+        slots = new Slot[EPOCH_MAX_THREADS];
+    }
+
+    /**
+     * @brief Destructor.
+     *
+     * Deletes every retired object. No thread may be pinned any more.
+     */
+    ~EpochManager(){
+        for (Retired& entry : retired) entry.deleter(entry.object);
+        delete[] slots;
+    }
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Pins the manager for the calling thread.
+     *
+     * While the returned guard lives, no object that the thread can still reach is deleted.
+     * Pins nest: only the outermost guard unpins.
+     *
+     * @return Guard The guard that unpins the manager.
+     */
+    Guard pin();
+
+    /**
+     * @brief Hands over an object that is no longer reachable from the shared structure.
+     *
+     * The object must already be unlinked. It is deleted by a later retire() call or by the
+     * destructor, once no reader can hold it.
+     *
+     * @param object The object.
+     * @param deleter Deletes the object.
+     */
+    void retire(void* object, void (*deleter)(void*));
+
+    /**
+     * @brief Deletes every retired object that no pinned reader can hold.
+     */
+    void reclaim();
+
+    /**
+     * @brief Retrieves the number of retired objects that are not deleted yet.
+     *
+     * @return std::size_t The number of objects.
+     */
+    std::size_t pending(){
+        std::lock_guard<std::mutex> guard(retired_lock);
+        return retired.size();
+    }
+
+
+protected:
+    /**
+     * @brief Deletes the retired objects that are safe to delete. retired_lock must be held.
+     */
+    void reclaim_locked();
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+inline EpochManager::Guard EpochManager::pin(){
+    Slot* slot = &slots[epoch_thread_index()];
+    if (slot->depth++ == 0){
+        slot->epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // the announcement must be visible before any shared pointer is read, pairs with the fence in reclaim_locked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return Guard(this, slot);
+}
+
+inline void EpochManager::retire(void* object, void (*deleter)(void*)){
+    // readers that pin from now on see the object already unlinked
+    uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_acq_rel);
+
+    std::lock_guard<std::mutex> guard(retired_lock);
+    retired.push_back(Retired{epoch, object, deleter});
+    if (retired.size() % RECLAIM_BATCH == 0) reclaim_locked();
+}
+
+inline void EpochManager::reclaim(){
+    std::lock_guard<std::mutex> guard(retired_lock);
+    reclaim_locked();
+}
+
+
+//protected:
+
+inline void EpochManager::reclaim_locked(){
+    // pairs with the fence in pin: either the reader's slot is seen here, or the reader sees the unlink
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64_t oldest = IDLE;
+    for (int i = 0; i < EPOCH_MAX_THREADS; i++){
+        uint64_t epoch = slots[i].epoch.load(std::memory_order_acquire);
+        if (epoch < oldest) oldest = epoch;
+    }
+
+    // an object retired at epoch e is safe once every pinned reader pinned after e
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired.size(); i++){
+        if (retired[i].epoch < oldest) retired[i].deleter(retired[i].object);
+        else retired[kept++] = retired[i];
+    }
+    retired.resize(kept);
+}
+
+#endif //LEARNING_EPOCHMANAGER_H
@@ -0,0 +1,264 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "HashPolicy.h"
+
+#ifndef LEARNING_FROZENFORMAT_H
+#define LEARNING_FROZENFORMAT_H
+
+
+/**
+ * @brief The on-disk layout of a frozen HashDict, written by HashDict::freeze() and read by MappedHashDict.
+ *
+ * A frozen dict is one position-independent image, every reference inside it is an offset
+ * from its first byte:
+ * - FrozenHeader;
+ * - bucket_count + 1 uint64_t offsets, the entries of bucket b are entries[offsets[b]] ... entries[offsets[b + 1] - 1];
+ * - entry_count FrozenEntry records: the full hash, the key slot and the value slot;
+ * - the blob, the bytes of all string keys and values.
+ *
+ * The bucket count is a power of two and hashes are mapped with map_to_bucket in POWER_OF_TWO
+ * mode. Numbers are stored in the byte order of the writing machine, and the header records it.
+ */
+const uint32_t FROZEN_VERSION = 2;                  /**< The version of the layout written by this code. */
+const uint32_t FROZEN_BYTE_ORDER = 0x01020304;      /**< Reads back differently on a machine of the other byte order. */
+
+
+/**
+ * @brief The header of a frozen dict image.
+ */
+struct FrozenHeader {
+    char magic[8];               /**< "HDFROZEN". */
+    uint32_t version;            /**< FROZEN_VERSION. */
+    uint32_t byte_order;         /**< FROZEN_BYTE_ORDER. */
+    uint32_t key_tag;            /**< FrozenCodec<key_t>::TAG, checked by the reader. */
+    uint32_t value_tag;          /**< FrozenCodec<value_t>::TAG, checked by the reader. */
+    uint64_t bucket_count;       /**< The number of buckets, a power of two. */
+    uint64_t entry_count;        /**< The number of key-value pairs. */
+    uint64_t offsets_offset;     /**< Where the bucket offsets start. */
+    uint64_t entries_offset;     /**< Where the entries start. */
+    uint64_t blob_offset;        /**< Where the string bytes start. */
+    uint64_t file_size;          /**< The size of the whole image. */
+};
+
+
+/**
+ * @brief A string stored in the blob of a frozen dict.
+ */
+struct FrozenString {
+    uint64_t offset;             /**< The offset of the first byte inside the blob. */
+    uint64_t length;             /**< The number of bytes. */
+};
+
+
+/**
+ * @brief The header tag of a trivially copyable type: its size and what kind of type it is.
+ *
+ * The kind keeps int, unsigned int and float, all four bytes, from being read as each other.
+ * Two class types of the same size still get the same tag; specialize FrozenCodec to tell
+ * them apart.
+ *
+ * @tparam T The type.
+ * @return uint32_t The kind in the high byte, the size below it.
+ */
+template<typename T>
+constexpr uint32_t frozen_tag(){
+    uint32_t kind = std::is_same<T, bool>::value ? 1
+                  : std::is_floating_point<T>::value ? 2
+                  : std::is_integral<T>::value ? (std::is_signed<T>::value ? 3 : 4)
+                  : std::is_enum<T>::value ? 5
+                  : std::is_pointer<T>::value ? 6 : 7;
+    return kind << 24 | static_cast<uint32_t>(sizeof(T));
+}
+
+
+/**
+ * @brief How a key or value type is stored in a frozen dict.
+ *
+ * Trivially copyable types are stored as they are. std::string is stored in the blob and read
+ * back as a std::string_view into the mapping. Other types have no frozen form.
+ *
+ * @tparam T The type of the keys or values.
+ */
+template<typename T, typename Enable = void>
+struct FrozenCodec {
+    static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types and std::string can be frozen");
+};
+
+template<typename T>
+struct FrozenCodec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+    using slot_type = T;                        /**< What an entry holds. */
+    using find_type = const T*;                 /**< What MappedHashDict::find returns, nullptr if absent. */
+    static const uint32_t TAG = frozen_tag<T>();    /**< Identifies the stored type in the header. */
+
+    static slot_type store(const T& value, std::string&){
+        return value;
+    }
+
+    static find_type found(const slot_type& slot, const char*){
+        return &slot;
+    }
+
+    static find_type missing(){
+        return nullptr;
+    }
+
+    static bool matches(const slot_type& slot, const char*, const T& key){
+        return slot == key;
+    }
+
+    static bool fits(const slot_type&, uint64_t){
+        return true;
+    }
+};
+
+template<>
+struct FrozenCodec<std::string> {
+    using slot_type = FrozenString;
+    using find_type = std::optional<std::string_view>;
+    static const uint32_t TAG = 0x80000000U;
+
+    static slot_type store(const std::string& value, std::string& blob){
+        FrozenString slot{blob.size(), value.size()};
+        blob += value;
+        return slot;
+    }
+
+    static find_type found(const slot_type& slot, const char* blob){
+        return std::string_view(blob + slot.offset, slot.length);
+    }
+
+    static find_type missing(){
+        return std::nullopt;
+    }
+
+    static bool matches(const slot_type& slot, const char* blob, const std::string& key){
+        return slot.length == key.size() && std::memcmp(blob + slot.offset, key.data(), key.size()) == 0;
+    }
+
+    /**
+     * @brief Checks that the string lies inside a blob of blob_size bytes, without overflowing.
+     */
+    static bool fits(const slot_type& slot, uint64_t blob_size){
+        return slot.offset <= blob_size && slot.length <= blob_size - slot.offset;
+    }
+};
+
+
+/**
+ * @brief One key-value pair of a frozen dict.
+ *
+ * @tparam key_t The type of the keys.
+ * @tparam value_t The type of the values.
+ */
+template<typename key_t, typename value_t>
+struct FrozenEntry {
+    uint64_t hash;                                           /**< The full hash of the key. */
+    typename FrozenCodec<key_t>::slot_type key;              /**< The key or its blob reference. */
+    typename FrozenCodec<value_t>::slot_type value;          /**< The value or its blob reference. */
+};
+
+
+/**
+ * @brief Rounds an offset up to a multiple of 8, every section of the image starts aligned.
+ */
+inline uint64_t frozen_align(uint64_t offset){
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+
+/**
+ * @brief Builds a frozen dict image.
+ *
+ * Example:
+ * @code
+ * std::string image = freeze_entries<int, double>(count, [&](auto&& emit){
+ *     for (...) emit(hash, key, value);
+ * });
+ * @endcode
+ *
+ * @tparam key_t The type of the keys.
+ * @tparam value_t The type of the values.
+ * @param count The number of pairs.
+ * @param for_each Called twice as for_each(emit); both calls must give every pair to emit(uint64_t hash, const key_t&, const value_t&) in the same way.
+ * @return std::string The image.
+ */
+template<typename key_t, typename value_t, typename ForEach>
+std::string freeze_entries(std::size_t count, ForEach&& for_each){
+    using entry_type = FrozenEntry<key_t, value_t>;
+    static_assert(alignof(entry_type) <= 8, "frozen entries must not need more than 8-byte alignment");
+
+    uint64_t bucket_count = 1;
+    while (bucket_count < count) bucket_count *= 2;
+
+    // first pass: the hashes and their buckets, counted per bucket
+    std::vector<uint64_t> hashes;
+    hashes.reserve(count);
+    std::vector<uint64_t> offsets(bucket_count + 1, 0);
+    for_each([&](uint64_t hash, const key_t&, const value_t&){
+        hashes.push_back(hash);
+        offsets[map_to_bucket(hash, static_cast<int>(bucket_count), SizingMode::POWER_OF_TWO) + 1]++;
+    });
+    for (uint64_t b = 0; b < bucket_count; b++) offsets[b + 1] += offsets[b];
+
+    FrozenHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HDFROZEN", 8);
+    header.version = FROZEN_VERSION;
+    header.byte_order = FROZEN_BYTE_ORDER;
+    header.key_tag = FrozenCodec<key_t>::TAG;
+    header.value_tag = FrozenCodec<value_t>::TAG;
+    header.bucket_count = bucket_count;
+    header.entry_count = hashes.size();
+    header.offsets_offset = frozen_align(sizeof(FrozenHeader));
+    header.entries_offset = frozen_align(header.offsets_offset + offsets.size() * sizeof(uint64_t));
+    header.blob_offset = frozen_align(header.entries_offset + hashes.size() * sizeof(entry_type));
+
+    // second pass: every entry goes to the next free place of its bucket
+    std::string entries(hashes.size() * sizeof(entry_type), '\0');
+    std::string blob;
+    std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+    for_each([&](uint64_t hash, const key_t& key, const value_t& value){
+        uint64_t position = next[map_to_bucket(hash, static_cast<int>(bucket_count), SizingMode::POWER_OF_TWO)]++;
+        entry_type entry;
+        std::memset(static_cast<void*>(&entry), 0, sizeof(entry));
+        entry.hash = hash;
+        entry.key = FrozenCodec<key_t>::store(key, blob);
+        entry.value = FrozenCodec<value_t>::store(value, blob);
+        std::memcpy(&entries[position * sizeof(entry_type)], &entry, sizeof(entry));
+    });
+    header.file_size = header.blob_offset + blob.size();
+
+    std::string image(header.file_size, '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    std::memcpy(&image[header.offsets_offset], offsets.data(), offsets.size() * sizeof(uint64_t));
+    if (!entries.empty()) std::memcpy(&image[header.entries_offset], entries.data(), entries.size());
+    if (!blob.empty()) std::memcpy(&image[header.blob_offset], blob.data(), blob.size());
+    return image;
+}
+
+
+/**
+ * @brief Writes an image to a file, replacing it.
+ *
+ * @param path The path of the file.
+ * @param image The bytes to write.
+ * @throws std::logic_error If the file cannot be written.
+ */
+inline void write_frozen_file(const std::string& path, const std::string& image){
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::logic_error("can't open the file for writing!!!");
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!out) throw std::logic_error("can't write the file!!!");
+}
+
+#endif //LEARNING_FROZENFORMAT_H
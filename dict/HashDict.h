@@ -2,36 +2,146 @@
 // Created by Volodymyr Avvakumov on 27.10.2024.
 //
 
+#include <cmath>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
 #include "LinkedList_dict.h"
+#include "HashPolicy.h"
+#include "NodePool.h"
+#include "Hashing.h"
+#include "Parallel.h"
+#include "FrozenFormat.h"
 
 #ifndef LEARNING_HASHDICT_H
 #define LEARNING_HASHDICT_H
 
+/**
+ * @brief A key-value pair of a HashDict as seen through its iterators.
+ *
+ * Holds references into the node, so nothing is copied and assigning to value changes the
+ * dictionary. Works with structured bindings:
+ * @code
+ * for (auto [key, value] : dict) value *= 2;
+ * @endcode
+ *
+ * @tparam key_type The type of the key.
+ * @tparam value_type The type of the value, const for const iterators.
+ */
+template<typename key_type, typename value_type>
+struct DictEntry {
+    const key_type& key;   /**< The key of the entry. */
+    value_type& value;     /**< The value of the entry. */
+};
+
+
 /**
  * @brief A templated HashDict class implementing a hash table using separate chaining.
  *
  * This class provides functionality to add, check, and remove key-value pairs.
- * It automatically resizes when the occupancy exceeds 75% to maintain efficiency.
+ * It automatically resizes when the load factor (elements per bucket) exceeds the maximum
+ * load factor, 0.75 by default. reserve() presizes the table for a known number of elements,
+ * and with set_auto_shrink(true) the table also shrinks once it becomes sparse.
+ *
+ * By default a resize rehashes the whole table inside one add() call. With incremental
+ * rehashing enabled (set_incremental_rehash) the old and the new bucket arrays coexist
+ * after a resize and every add/pop/is_in migrates only a few old buckets, so no single
+ * operation pays for the whole table.
+ *
+ * The bucket count is a prime by default. set_sizing_mode(SizingMode::POWER_OF_TWO) switches
+ * an instance to power-of-two bucket counts, where a hash is mapped to its bucket with a
+ * multiply and a shift instead of an integer division.
+ *
+ * Chain nodes come from a NodePool owned by the instance, so inserts and pops rarely touch
+ * the global allocator. For small entries (see should_inline_first) the first entry of every
+ * bucket lives inside the bucket array itself, so a lookup that hits it touches one cache line
+ * instead of two.
+ *
+ * Pointers to values: an entry in a pool node never moves, so a pointer to its value stays
+ * valid until the entry is erased. An entry stored inline, or in the small mode below, is
+ * moved when its storage goes away, which invalidates pointers to its value. That happens on
+ * - every resize: an add, emplace, try_emplace, insert_or_assign, add_many or build_parallel
+ *   that grows the table, reserve, rehash, shrink_to_fit, set_max_load_factor,
+ *   set_sizing_mode, and erase or pop with auto_shrink;
+ * - with incremental rehashing, every operation that migrates old buckets while a migration
+ *   is running: the inserts above, erase, pop, set_incremental_rehash(false), and the
+ *   non-const find(), find_many(), is_in() and operator[]. The const overloads never migrate.
+ * A moved entry keeps its key and value, only their address changes.
+ *
+ * A new HashDict starts in the small mode: its first 4 to 8 entries (see small_dict_capacity)
+ * are packed in an array of nodes inside the object, a lookup compares the keys one by one
+ * without hashing, and nothing is allocated, not even for an empty dict. The first add that
+ * does not fit allocates the bucket array and moves the entries there; if that allocation
+ * fails, the dict is left as it was. From then on the dict stays hashed, and the bytes of the
+ * small mode hold its node pool. Erasing in the small mode moves the last entry into the hole.
  *
  * @tparam key_t The type of keys stored in the HashDict.
  * @tparam value_t The type of values associated with the keys.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, std::equal_to<key_t> by default.
  */
 
-template<typename key_t,typename value_t>
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
 class HashDict {
 protected:
     int real_size;                                /**< The current size of the hash table. */
     int element_count;                            /**< The number of key-value pairs currently in the hash dictionary. */
     int curr_pow_for_primes;                      /**< The current power used to determine the next prime size. */
+    SizingMode sizing_mode;                       /**< How the bucket count is chosen and hashes are mapped to buckets. */
+
+    float max_load_factor;                        /**< The largest allowed number of elements per bucket. */
+    int grow_threshold;                           /**< The table grows when element_count exceeds this. */
+    int shrink_threshold;                         /**< With auto_shrink, the table shrinks when element_count drops below this. */
+
+    static const int MIN_SIZE = 5;                /**< The smallest bucket count of a hashed dict. */
+
+    int old_size;                                 /**< The size of old_arr. */
+    int migrate_pos;                              /**< Buckets of old_arr below this index are already migrated. */
+
+    static const int REHASH_STEP = 4;             /**< The number of old buckets migrated by each operation. */
+
+    // the flags and the functors sit together, so an empty functor takes no padding of its own
+    bool auto_shrink;                             /**< Whether erasing elements can shrink the table. */
+    bool incremental_rehash;                      /**< Whether resizes are spread over later operations. */
+    Hash hasher;                                  /**< The hash functor. */
+    KeyEqual key_equal;                           /**< The key comparison functor. */
 
     LinkedList_dict<key_t, value_t>* element_arr; /**< Array of linked lists for separate chaining. */
+    LinkedList_dict<key_t, value_t>* old_arr;     /**< The bucket array being migrated, nullptr if no migration is running. */
+
+    static const int SMALL_CAPACITY = small_dict_capacity<key_t, value_t>::value;    /**< Entries of the small mode. */
+
+    /**
+     * @brief Everything the small mode keeps inside the object.
+     *
+     * The entries fill nodes[0] to nodes[bucket.size - 1]. They are also chained into the bucket,
+     * newest first, so iterating and moving them out work as for any other bucket.
+     */
+    struct SmallStorage {
+        LinkedList_dict<key_t, value_t> bucket;                       /**< The only bucket while the dict is small. */
+        SmallNodes<ListEl<key_t, value_t>, SMALL_CAPACITY> nodes;      /**< The entries of the small mode. */
+    };
+
+    // a dict is either small or has a pool, never both, so the two share their bytes
+    union {
+        NodePool<ListEl<key_t, value_t>> pool;    /**< Storage of all chain nodes once the dict is hashed. */
+        SmallStorage small;                       /**< The bucket and the nodes while the dict is small. */
+    };
 public:
     /**
      * @brief Default constructor.
      *
      * Initializes the hash dictionary with a default size and sets up the linked lists.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
      */
-    HashDict();
+    explicit HashDict(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
 
     /**
      * @brief Destructor.
@@ -39,18 +149,94 @@ public:
      * Cleans up the allocated memory for the hash table.
      */
     ~HashDict(){
-        delete[] element_arr;
+        destroy_nodes(element_arr, real_size);
+        destroy_nodes(old_arr, old_size);
+        delete[] old_arr;
+        if (is_small()){
+            small.~SmallStorage();
+        } else {
+            delete[] element_arr;
+            pool.~NodePool();
+        }
     }
 
     /**
      * @brief Adds a key-value pair to the HashDict.
      *
+     * Does nothing if the key is already present.
      * If the occupancy exceeds 75%, the hash table is resized to maintain performance.
      *
      * @param key The key to be added.
      * @param value The value associated with the key.
      */
-    void add(key_t key, value_t value);
+    void add(const key_t& key, const value_t& value);
+
+    /**
+     * @brief Adds a key-value pair to the HashDict, moving whatever arguments are rvalues.
+     *
+     * Same as add(const key_t&, const value_t&), but the key and the value are forwarded into
+     * the new node, so temporaries are moved instead of copied.
+     *
+     * @param key The key to be added.
+     * @param value The value associated with the key.
+     */
+    template<typename K, typename V>
+    void add(K&& key, V&& value);
+
+    /**
+     * @brief Constructs a key-value pair in place if the key is not present yet.
+     *
+     * A key of another type is converted to key_t once and then moved into the node. The
+     * value is built directly inside the node from args, and only if the key is absent.
+     *
+     * Example:
+     * @code
+     * HashDict<std::string, std::vector<int>> dict;
+     * dict.emplace("zeros", 100, 0); // the vector is constructed inside the node
+     * @endcode
+     *
+     * @param key The key, or an argument key_t can be constructed from.
+     * @param args Arguments forwarded to the constructor of the value.
+     * @return std::pair<value_t*, bool> Pointer to the value stored under the key, and whether it was inserted.
+     */
+    template<typename K, typename... Args>
+    std::pair<value_t*, bool> emplace(K&& key, Args&&... args);
+
+    /**
+     * @brief Constructs the value in place if the key is not present, does nothing otherwise.
+     *
+     * The key is hashed and its chain is walked once. When the key exists, args are left untouched.
+     *
+     * @param key The key to look for.
+     * @param args Arguments forwarded to the constructor of the value.
+     * @return std::pair<value_t*, bool> Pointer to the value stored under the key, and whether it was inserted.
+     */
+    template<typename... Args>
+    std::pair<value_t*, bool> try_emplace(const key_t& key, Args&&... args);
+
+    /**
+     * @brief Same as try_emplace(const key_t&, Args&&...), but the key is moved into the new node.
+     */
+    template<typename... Args>
+    std::pair<value_t*, bool> try_emplace(key_t&& key, Args&&... args);
+
+    /**
+     * @brief Inserts a key-value pair, or assigns the value if the key is already present.
+     *
+     * The key is hashed and its chain is walked once.
+     *
+     * @param key The key.
+     * @param value The value to insert or assign.
+     * @return std::pair<value_t*, bool> Pointer to the value stored under the key, and whether it was inserted.
+     */
+    template<typename V>
+    std::pair<value_t*, bool> insert_or_assign(const key_t& key, V&& value);
+
+    /**
+     * @brief Same as insert_or_assign(const key_t&, V&&), but the key is moved into a new node.
+     */
+    template<typename V>
+    std::pair<value_t*, bool> insert_or_assign(key_t&& key, V&& value);
 
     /**
      * @brief Removes a key-value pair from the HashDict.
@@ -60,7 +246,7 @@ public:
      * @param key The key to be removed.
      * @throws std::logic_error If the key is not found.
      */
-    void pop(key_t key);
+    void pop(const key_t& key);
 
     /**
      * @brief Checks if a key exists in the HashDict.
@@ -71,7 +257,137 @@ public:
      * @return true If the key is present.
      * @return false Otherwise.
      */
-    bool is_in(key_t key);
+    bool is_in(const key_t& key);
+
+    /**
+     * @brief Finds the value associated with a key.
+     *
+     * Hashes the key once and walks one chain. Unlike operator[], a missing key is not an error.
+     *
+     * Example:
+     * @code
+     * if (int* count = dict.find("apple")) (*count)++;
+     * @endcode
+     *
+     * @param key The key to look for.
+     * @return value_t* Pointer to the value, or nullptr if the key is not present.
+     */
+    value_t* find(const key_t& key);
+
+    /**
+     * @brief Finds the value associated with a key (const version).
+     *
+     * @param key The key to look for.
+     * @return const value_t* Pointer to the value, or nullptr if the key is not present.
+     */
+    const value_t* find(const key_t& key) const;
+
+    /**
+     * @brief Retrieves a copy of the value associated with a key, if there is one.
+     *
+     * @param key The key to look for.
+     * @return std::optional<value_t> The value, or std::nullopt if the key is not present.
+     */
+    std::optional<value_t> try_get(const key_t& key) const;
+
+    /**
+     * @brief Removes a key-value pair if the key is present.
+     *
+     * The non-throwing counterpart of pop().
+     *
+     * @param key The key to be removed.
+     * @return true If the key was found and removed.
+     * @return false If the key was not present.
+     */
+    bool erase(const key_t& key);
+
+    /**
+     * @brief Checks a batch of keys at once.
+     *
+     * Keys are processed in groups of PREFETCH_GROUP: the whole group is hashed and its
+     * buckets are prefetched, then the first node of every bucket, and only then is each key
+     * resolved. The memory latencies of a group overlap instead of being paid one by one,
+     * which pays off on tables much larger than the CPU cache.
+     *
+     * @param keys Pointer to the keys.
+     * @param count The number of keys.
+     * @param results Output array of count flags, results[i] tells whether keys[i] is present.
+     */
+    void contains_many(const key_t* keys, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Finds a batch of keys at once, in groups like contains_many.
+     *
+     * @param keys Pointer to the keys.
+     * @param count The number of keys.
+     * @param results Output array of count pointers to the values, nullptr for missing keys.
+     */
+    void find_many(const key_t* keys, std::size_t count, value_t** results);
+
+    /**
+     * @brief Finds a batch of keys at once (const version).
+     *
+     * @param keys Pointer to the keys.
+     * @param count The number of keys.
+     * @param results Output array of count pointers to the values, nullptr for missing keys.
+     */
+    void find_many(const key_t* keys, std::size_t count, const value_t** results) const;
+
+    /**
+     * @brief Adds a batch of key-value pairs at once.
+     *
+     * Reserves room for all pairs first, so the table grows at most once, and then inserts
+     * them in groups like contains_many. As with add(), keys that are already present are skipped.
+     *
+     * @param keys Pointer to the keys.
+     * @param values Pointer to the values, values[i] belongs to keys[i].
+     * @param count The number of pairs.
+     */
+    void add_many(const key_t* keys, const value_t* values, std::size_t count);
+
+    /**
+     * @brief Adds a range of key-value pairs using several threads.
+     *
+     * The table is sized for the final element count once, up front. All keys are then hashed
+     * in parallel and grouped by bucket range, and every thread links the pairs of its own
+     * buckets with nodes from its own NodePool, so no locks are taken. The pools are merged
+     * into the dictionary's pool at the end. As with add(), keys that are already present are
+     * skipped, and of equal keys in the range the first one wins.
+     *
+     * Hash, KeyEqual and the copy constructors of key_t and value_t are called from several
+     * threads at once. Small ranges are built on the calling thread only.
+     *
+     * Example:
+     * @code
+     * std::vector<std::pair<std::string, int>> rows = load_rows();
+     * dict.build_parallel(rows.begin(), rows.end());
+     * @endcode
+     *
+     * @param begin Random access iterator to the first pair, .first is the key and .second the value.
+     * @param end Iterator past the last pair.
+     * @param threads The number of threads, 0 for one per hardware thread.
+     */
+    template<typename RandomIt>
+    void build_parallel(RandomIt begin, RandomIt end, int threads = 0);
+
+    /**
+     * @brief Serializes the HashDict into an immutable, position-independent image.
+     *
+     * The layout is described in FrozenFormat.h. Keys and values must be trivially copyable or
+     * std::string. The image stores the hashes computed by Hash, so a MappedHashDict can only
+     * read it with a Hash that gives the same results in every process, like DefaultHash.
+     *
+     * @return std::string The image.
+     */
+    std::string freeze() const;
+
+    /**
+     * @brief Writes freeze() to a file, for MappedHashDict to map.
+     *
+     * @param path The path of the file, replaced if it exists.
+     * @throws std::logic_error If the file cannot be written.
+     */
+    void save(const std::string& path) const;
 
     /**
      * @brief Retrieves the number of key-value pairs in the HashDict.
@@ -91,6 +407,108 @@ public:
         return real_size;
     }
 
+    /**
+     * @brief Enables or disables incremental rehashing.
+     *
+     * Disabling it finishes a migration that is still running.
+     *
+     * @param enabled true to spread resizes over later operations.
+     */
+    void set_incremental_rehash(bool enabled);
+
+    /**
+     * @brief Checks if a migration from an old bucket array is still running.
+     *
+     * @return true If old buckets are still being migrated.
+     * @return false Otherwise.
+     */
+    [[nodiscard]] bool is_rehashing() const {
+        return old_arr != nullptr;
+    }
+
+    /**
+     * @brief Switches the way the bucket count is chosen and hashes are mapped to buckets.
+     *
+     * The table is rebuilt right away: for POWER_OF_TWO the bucket count is rounded up to a
+     * power of two, for PRIME the next resize goes back to prime sizes.
+     *
+     * @param mode The new sizing mode.
+     */
+    void set_sizing_mode(SizingMode mode);
+
+    /**
+     * @brief Retrieves the current sizing mode.
+     *
+     * @return SizingMode The sizing mode of this instance.
+     */
+    [[nodiscard]] SizingMode get_sizing_mode() const {
+        return sizing_mode;
+    }
+
+    /**
+     * @brief Presizes the table so that count elements fit without any further resize.
+     *
+     * Never shrinks the table. Call it before a bulk load of a known size.
+     *
+     * @param count The number of elements the table should hold.
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Rebuilds the table with at least bucket_count buckets.
+     *
+     * The bucket count is raised to what the current elements need under the maximum load
+     * factor and then rounded up to a prime or a power of two, depending on the sizing mode.
+     *
+     * @param bucket_count The requested number of buckets.
+     */
+    void rehash(int bucket_count);
+
+    /**
+     * @brief Shrinks the table to the smallest bucket count that fits the current elements.
+     */
+    void shrink_to_fit();
+
+    /**
+     * @brief Retrieves the current load factor.
+     *
+     * @return float The number of elements per bucket.
+     */
+    [[nodiscard]] float load_factor() const {
+        return static_cast<float>(element_count) / real_size;
+    }
+
+    /**
+     * @brief Retrieves the maximum load factor.
+     *
+     * @return float The largest allowed number of elements per bucket.
+     */
+    [[nodiscard]] float get_max_load_factor() const {
+        return max_load_factor;
+    }
+
+    /**
+     * @brief Sets the maximum load factor, growing the table right away if it is exceeded.
+     *
+     * @param factor The largest allowed number of elements per bucket.
+     * @throws std::logic_error If factor is not positive.
+     */
+    void set_max_load_factor(float factor);
+
+    /**
+     * @brief Enables or disables automatic shrinking.
+     *
+     * When enabled, the table shrinks once the load factor drops below a quarter of the
+     * maximum one. The new table is half full, so a table that shrank needs to double its
+     * element count before it grows again, and it does not flip back and forth under churn.
+     *
+     * @param enabled true to let erase() and pop() shrink the table.
+     */
+    void set_auto_shrink(bool enabled){
+        auto_shrink = enabled;
+        update_thresholds();
+    }
+
 
     // operators
 
@@ -112,7 +530,7 @@ public:
      * @return value_t& Reference to the value associated with the key.
      * @throws std::logic_error If the key is not found.
      */
-    value_t& operator[](key_t key);
+    value_t& operator[](const key_t& key);
 
 
     /**
@@ -132,7 +550,149 @@ public:
      * @return const value_t& Const reference to the value associated with the key.
      * @throws std::logic_error If the key is not found.
      */
-    const value_t& operator[](key_t key) const;
+    const value_t& operator[](const key_t& key) const;
+
+    /**
+     * @brief A forward iterator over all key-value pairs of the HashDict.
+     *
+     * Walks the buckets and their chains once, so a full scan is O(n + number of buckets).
+     * While an incremental migration is running, the buckets that still wait in the old array
+     * are visited first. Any add, erase or resize invalidates all iterators, and so does a
+     * non-const lookup while a migration is running.
+     *
+     * @tparam is_const Whether the iterator gives read-only access to the values.
+     */
+    template<bool is_const>
+    class Iterator {
+    private:
+        const HashDict* dict;                  /**< The dictionary being iterated. */
+        bool in_old;                           /**< Whether the current bucket belongs to the old array. */
+        int bucket;                            /**< The index of the current bucket. */
+        ListEl<key_t, value_t>* current;       /**< The current node, nullptr at the end. */
+
+        template<bool> friend class Iterator;
+        friend class HashDict;
+
+        Iterator(const HashDict* owner, bool old_buckets, int bucket_index, ListEl<key_t, value_t>* node)
+                : dict(owner), in_old(old_buckets), bucket(bucket_index), current(node) {}
+
+        /**
+         * @brief Moves forward to the first node of the next non-empty bucket if there is no current node.
+         */
+        void settle();
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = DictEntry<key_t, typename std::conditional<is_const, const value_t, value_t>::type>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        Iterator() : dict(nullptr), in_old(false), bucket(0), current(nullptr) {}
+
+        /**
+         * @brief Converts a mutable iterator into a const one.
+         *
+         * @param other The mutable iterator.
+         */
+        template<bool other_const, typename = typename std::enable_if<is_const && !other_const>::type>
+        Iterator(const Iterator<other_const>& other)
+                : dict(other.dict), in_old(other.in_old), bucket(other.bucket), current(other.current) {}
+
+        /**
+         * @brief Dereferences the iterator.
+         *
+         * @return value_type References to the key and the value of the current entry.
+         */
+        value_type operator*() const {
+            return value_type{current->key, current->value};
+        }
+
+        /**
+         * @brief Gives member access to the current entry, as in it->key and it->value.
+         */
+        struct ArrowProxy {
+            value_type entry;                                       /**< The current entry. */
+            const value_type* operator->() const { return &entry; }
+        };
+
+        ArrowProxy operator->() const {
+            return ArrowProxy{**this};
+        }
+
+        /**
+         * @brief Advances the iterator to the next entry.
+         *
+         * @return Iterator& Reference to the updated iterator.
+         */
+        Iterator& operator++(){
+            current = current->next_pointer;
+            settle();
+            return *this;
+        }
+
+        /**
+         * @brief Advances the iterator to the next entry (postfix version).
+         *
+         * @return Iterator The iterator before the increment.
+         */
+        Iterator operator++(int){
+            Iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return current == other.current;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return current != other.current;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief Returns an iterator to the first entry.
+     *
+     * Example:
+     * @code
+     * long long total = 0;
+     * for (auto entry : dict) total += entry.value;
+     * @endcode
+     *
+     * @return iterator An iterator to the first entry, equal to end() if the HashDict is empty.
+     */
+    iterator begin(){
+        return make_begin<false>();
+    }
+
+    /**
+     * @brief Returns an iterator past the last entry.
+     *
+     * @return iterator The end iterator.
+     */
+    iterator end(){
+        return iterator(this, false, real_size, nullptr);
+    }
+
+    const_iterator begin() const {
+        return make_begin<true>();
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, false, real_size, nullptr);
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
 
     /**
      * @brief Prints the contents of the HashDict.
@@ -147,96 +707,322 @@ public:
 protected:
 
     /**
-     * @brief Adds a key-value pair to a specified array.
+     * @brief Computes the hash of a key with the Hash functor.
      *
-     * Used internally when resizing the hash table to add elements to the new array.
+     * @param key The key to hash.
+     * @return std::size_t The computed hash.
+     */
+    std::size_t getHash(const key_t& key) const {
+        return hasher(key);
+    }
+
+    /**
+     * @brief Finds the bucket index of a hash in a bucket array of the given size.
      *
-     * @param arr Pointer to the new array of linked lists.
-     * @param arr_size The size of the new array.
-     * @param key The key to add.
-     * @param value The value associated with the key.
+     * @param hash The hash of the key.
+     * @param size The size of the bucket array.
+     * @return int The bucket index.
      */
-    void add_to_array(LinkedList_dict<key_t, value_t>* arr,int arr_size, key_t key, value_t value);
+    int position_of(std::size_t hash, int size) const {
+        return map_to_bucket(hash, size, sizing_mode);
+    }
 
     /**
-     * @brief Computes the hash for integral types.
+     * @brief Retrieves the hash of the key stored in a node.
+     *
+     * Uses the cached hash when the node has one and hashes the key again otherwise. Nodes of
+     * the small mode never have a hash, it is computed when they move out.
      *
-     * Uses bitwise operations to generate a hash value for integers.
+     * @param node The node.
+     * @return std::size_t The hash of the node's key.
+     */
+    std::size_t node_hash(const ListEl<key_t, value_t>* node) const {
+        if constexpr (should_cache_hash<key_t>::value){
+            if (!in_small_nodes(node)) return node->hash;
+        }
+        return getHash(node->key);
+    }
+
+    /**
+     * @brief Recomputes grow_threshold and shrink_threshold for the current size.
+     */
+    void update_thresholds();
+
+    /**
+     * @brief Builds an iterator to the first entry, starting from the old buckets during a migration.
      *
-     * @tparam T Integral type.
-     * @param value The value to hash.
-     * @param size The size of the hash table.
-     * @return long long int The computed hash modulo the table size.
+     * @tparam is_const Whether a const iterator is built.
+     * @return Iterator<is_const> The iterator.
      */
-    template <typename T>
-    typename std::enable_if<std::is_integral<T>::value, long long int>::type
-    getHash(T value, int size) const;
+    template<bool is_const>
+    Iterator<is_const> make_begin() const {
+        Iterator<is_const> it(this, old_arr != nullptr, old_arr != nullptr ? migrate_pos - 1 : -1, nullptr);
+        it.settle();
+        return it;
+    }
 
     /**
-     * @brief Computes the hash for floating-point types.
+     * @brief Chooses the smallest valid bucket count that is at least the given one.
      *
-     * Processes the binary representation of floating-point numbers to generate a hash.
+     * In PRIME mode this is the next prime, and the prime sequence of later resizes continues
+     * from it. In POWER_OF_TWO mode it is the next power of two.
      *
-     * @tparam T Floating-point type.
-     * @param value The value to hash.
-     * @param size The size of the hash table.
-     * @return long long int The computed hash modulo the table size.
+     * @param bucket_count The requested number of buckets.
+     * @return long long The bucket count to use.
      */
-    template <typename T>
-    typename std::enable_if<std::is_floating_point<T>::value, long long int>::type
-    getHash(T value, int size) const;
+    long long fit_size(long long bucket_count);
 
     /**
-     * @brief Computes the hash for pointer types.
+     * @brief Rebuilds the table with exactly new_size buckets, finishing any running migration first.
      *
-     * Hashes the memory address of the pointer.
+     * @param new_size The new number of buckets.
+     */
+    void rebuild(long long new_size);
+
+    /**
+     * @brief Resizes the hash table by creating a new array with a larger prime size.
      *
-     * @tparam T Pointer type.
-     * @param value The pointer to hash.
-     * @param size The size of the hash table.
-     * @return long long int The computed hash modulo the table size.
+     * Allocates a new array, rehashes existing elements, and replaces the old array.
+     * In incremental mode the old array is kept and only handed over to the migration.
      */
-    template <typename T>
-    typename std::enable_if<std::is_pointer<T>::value, long long int>::type
-    getHash(T value, int size) const;
+    void create_new_elements_arr();
 
     /**
-     * @brief Computes the hash for std::string.
+     * @brief Migrates the next REHASH_STEP buckets of the old array, if a migration is running.
      *
-     * Processes each character in the string to generate a hash.
+     * Frees the old array once its last bucket is migrated.
+     */
+    void migrate_step();
+
+    /**
+     * @brief Migrates all remaining buckets of the old array.
+     */
+    void finish_rehash();
+
+    /**
+     * @brief Finds the bucket a key belongs to.
+     *
+     * While a migration is running, a key whose old bucket has not been migrated yet lives in
+     * the old array, otherwise it lives in the current one, so exactly one chain is searched.
      *
-     * @param value The string to hash.
-     * @param size The size of the hash table.
-     * @return long long int The computed hash modulo the table size.
+     * @param hash The hash of the key to locate.
+     * @return LinkedList_dict<key_t, value_t>* The bucket of the key.
      */
-    [[nodiscard]] long long int getHash(const std::string& value, int size) const;
+    LinkedList_dict<key_t, value_t>* bucket_for(std::size_t hash) const;
 
     /**
-     * @brief Calculates the current occupancy of the hash table.
+     * @brief Finds the node holding a key inside one bucket.
      *
-     * Determines the percentage of filled elements relative to the total size.
+     * Keys are compared with the KeyEqual functor. When nodes cache their hash, the hashes
+     * are compared first, so the key comparison runs only for real candidates. In the small
+     * mode the hash is ignored and the entries are scanned, see find_small.
      *
-     * @return float The occupancy percentage.
+     * @param bucket The bucket to search.
+     * @param key The key to search for.
+     * @param hash The hash of the key.
+     * @param previous_element If not nullptr, set to the node before the found one (nullptr for the first node).
+     * @return ListEl<key_t, value_t>* The node holding the key, or nullptr if it is not in the bucket.
      */
-    float get_occupancy();
+    ListEl<key_t, value_t>* find_in_bucket(const LinkedList_dict<key_t, value_t>& bucket, const key_t& key, std::size_t hash,
+                                           ListEl<key_t, value_t>** previous_element = nullptr) const;
 
     /**
-     * @brief Resizes the hash table by creating a new array with a larger prime size.
+     * @brief Finds the node holding a key, searching the one bucket the key belongs to.
      *
-     * Allocates a new array, rehashes existing elements, and replaces the old array.
+     * @param key The key to search for.
+     * @return ListEl<key_t, value_t>* The node holding the key, or nullptr if it is not present.
      */
-    void create_new_elements_arr();
+    ListEl<key_t, value_t>* find_node(const key_t& key) const {
+        if (is_small()) return find_small(key); // no hash needed
+        std::size_t hash = getHash(key);
+        return find_in_bucket(*bucket_for(hash), key, hash);
+    }
+
+    /**
+     * @brief Finds the node holding a key among the entries of the small mode.
+     *
+     * The entries are packed at the front of small.nodes, so this is a linear scan of one
+     * block of memory with a key comparison per entry.
+     *
+     * @param key The key to search for.
+     * @return ListEl<key_t, value_t>* The node holding the key, or nullptr if it is not present.
+     */
+    ListEl<key_t, value_t>* find_small(const key_t& key) const;
+
+    /**
+     * @brief Removes an entry of the small mode, moving the last entry into its node.
+     *
+     * @param node The node of the entry, found by find_small.
+     */
+    void erase_small(ListEl<key_t, value_t>* node);
+
+    /**
+     * @brief Links a new node for the key unless the key is already present.
+     *
+     * Grows the table if needed, then hashes the key and walks its chain once. The node is
+     * constructed in place from the key and args only when the key is absent.
+     *
+     * @param key The key, const key_t& or key_t&&.
+     * @param args Arguments forwarded to the constructor of the value.
+     * @return std::pair<ListEl<key_t, value_t>*, bool> The node holding the key, and whether it was created.
+     */
+    template<typename K, typename... Args>
+    std::pair<ListEl<key_t, value_t>*, bool> insert_node(K&& key, Args&&... args);
+
+    /**
+     * @brief The part of insert_node that runs after the table has grown and the key is hashed.
+     *
+     * @param hash The hash of the key.
+     * @param key The key, const key_t& or key_t&&.
+     * @param args Arguments forwarded to the constructor of the value.
+     * @return std::pair<ListEl<key_t, value_t>*, bool> The node holding the key, and whether it was created.
+     */
+    template<typename K, typename... Args>
+    std::pair<ListEl<key_t, value_t>*, bool> insert_hashed(std::size_t hash, K&& key, Args&&... args);
+
+    /**
+     * @brief Checks whether the dict is still in the small mode, with small.bucket as its only bucket.
+     */
+    bool is_small() const {
+        return element_arr == &small.bucket;
+    }
+
+    /**
+     * @brief Checks whether a node lives in the node slots of the small mode.
+     */
+    bool in_small_nodes(const ListEl<key_t, value_t>* node) const {
+        return is_small() && small.nodes.owns(node);
+    }
+
+    /**
+     * @brief The number of entries the small mode holds.
+     */
+    static constexpr int small_limit(){
+        return SMALL_CAPACITY;
+    }
+
+    /**
+     * @brief Constructs a node for a bucket, not linked yet.
+     *
+     * In the small mode the node takes the next free slot of small.nodes; the small mode ends
+     * before the slots run out, so a small dict never takes a node from a pool. Otherwise the
+     * node takes the inline slot of the bucket when it is free and comes from a pool if not.
+     * While a migration is running the inline slots are left to the nodes the migration moves,
+     * see relocation_count().
+     *
+     * @param from The pool to take a node from.
+     * @param bucket The bucket the node will be linked into.
+     * @param args Arguments forwarded to the constructor of the node.
+     * @return ListEl<key_t, value_t>* The new node.
+     */
+    template<typename... Args>
+    ListEl<key_t, value_t>* create_node(NodePool<ListEl<key_t, value_t>>& from, LinkedList_dict<key_t, value_t>& bucket, Args&&... args){
+        if constexpr (SMALL_CAPACITY > 0){
+            if (&bucket == &small.bucket) return small.nodes.construct(bucket.size, std::forward<Args>(args)...);
+        }
+        if constexpr (LinkedList_dict<key_t, value_t>::INLINE){
+            if (bucket.inline_free() && old_arr == nullptr) return bucket.construct_inline(std::forward<Args>(args)...);
+        }
+        return from.create(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destroys an unlinked node of a bucket, giving it back to the bucket or to the pool.
+     *
+     * @param bucket The bucket the node belonged to.
+     * @param node The node.
+     */
+    void destroy_node(LinkedList_dict<key_t, value_t>& bucket, ListEl<key_t, value_t>* node){
+        if (bucket.owns_inline(node)) bucket.destroy_inline();
+        else if (in_small_nodes(node)) small.nodes.destroy(node);
+        else pool.destroy(node);
+    }
+
+    /**
+     * @brief Hashes a group of keys and prefetches their buckets and the first node of each.
+     *
+     * @param keys Pointer to the keys of the group.
+     * @param count The number of keys, at most PREFETCH_GROUP.
+     * @param hashes Output array of the hashes.
+     * @param buckets Output array of the buckets.
+     */
+    void prefetch_group(const key_t* keys, std::size_t count, std::size_t* hashes, LinkedList_dict<key_t, value_t>** buckets) const;
 
     /**
-     * @brief Copies all elements from the old hash table to the new one.
+     * @brief Gives every node of a bucket array back to the pool, leaving the buckets empty.
      *
-     * Rehashes each key-value pair and inserts it into the appropriate linked list in the new array.
+     * Must run before a bucket array is deleted, because the buckets do not own pooled nodes.
+     *
+     * @param arr The bucket array, may be nullptr.
+     * @param size The size of the array.
+     */
+    void destroy_nodes(LinkedList_dict<key_t, value_t>* arr, int size);
+
+    /**
+     * @brief Moves all nodes of one bucket into a new bucket array.
+     *
+     * Pooled nodes are relinked as they are. Only a node whose storage goes away with the old
+     * bucket or the small mode is moved: into the inline slot of its new bucket when that is
+     * free, into a reserved pool slot otherwise. The slots are reserved by new_bucket_array and
+     * inserts made while an incremental migration runs can't take them, so nothing here
+     * allocates and the migration can't fail halfway.
+     *
+     * @param bucket The bucket to empty.
+     * @param new_arr Pointer to the new array of linked lists.
+     * @param new_size The size of the new array.
+     * @param into The pool moved nodes are taken from.
+     */
+    void migrate_bucket(LinkedList_dict<key_t, value_t>& bucket, LinkedList_dict<key_t, value_t>* new_arr, int new_size,
+                        NodePool<ListEl<key_t, value_t>>& into);
+
+    /**
+     * @brief Moves all elements from the old hash table to the new one.
+     *
+     * Every node is unlinked from its old chain and linked in front of its new chain, so
+     * resizing is linear in the number of elements. Only inline and small nodes are moved,
+     * see migrate_bucket.
      *
      * @param new_arr Pointer to the new array of linked lists.
      * @param new_size The size of the new array.
      */
     void copy_list(LinkedList_dict<key_t, value_t>* new_arr, int new_size);
 
+    /**
+     * @brief Counts the pool nodes that migrating the current buckets into new_size buckets needs.
+     *
+     * Replays the order of the migration: a moved inline or small node takes the inline slot of
+     * its new bucket if no moved node took it before, and needs a pool node otherwise. Inserts
+     * don't take inline slots while a migration runs, so the count holds until it is over.
+     *
+     * @param new_size The size of the new array.
+     * @return std::size_t The number of pool nodes.
+     */
+    std::size_t relocation_count(int new_size);
+
+    /**
+     * @brief Allocates a bucket array for the next migration and reserves the pool nodes it needs.
+     *
+     * Nothing changes if this throws, and the migration into the array can't throw afterwards.
+     * The reservation is given back with into.reserve(0) once the migration is over.
+     *
+     * @param new_size The size of the new array.
+     * @param into The pool the moved nodes will be taken from.
+     * @return LinkedList_dict<key_t, value_t>* The new array.
+     */
+    LinkedList_dict<key_t, value_t>* new_bucket_array(long long new_size, NodePool<ListEl<key_t, value_t>>& into);
+
+
+    /**
+     * @brief Chooses the bucket count for the next resize.
+     *
+     * Doubles the size in POWER_OF_TWO mode and takes the next prime otherwise.
+     *
+     * @return long long The new size.
+     */
+    long long next_size(){
+        if (sizing_mode == SizingMode::POWER_OF_TWO) return (long long)real_size * 2;
+        return next_prime();
+    }
 
     /**
      * @brief Finds the next prime number for resizing the hash table.
@@ -278,64 +1064,317 @@ protected:
 
 //public:
 
-template<typename key_t,typename value_t>
-HashDict<key_t, value_t>::HashDict() {
-    real_size = 5;
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<bool is_const>
+void HashDict<key_t, value_t, Hash, KeyEqual>::Iterator<is_const>::settle(){
+    while (current == nullptr){
+        if (in_old){
+            if (++bucket < dict->old_size) current = dict->old_arr[bucket].first_el;
+            else {
+                // the old array is over, continuing with the current one
+                in_old = false;
+                bucket = -1;
+            }
+        } else {
+            if (++bucket < dict->real_size) current = dict->element_arr[bucket].first_el;
+            else return; // the end
+        }
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+HashDict<key_t, value_t, Hash, KeyEqual>::HashDict(const Hash& hash, const KeyEqual& equal) : hasher(hash), key_equal(equal) {
     element_count = 0;
     curr_pow_for_primes = 3;
-    element_arr = new LinkedList_dict<key_t, value_t>[real_size];
+    sizing_mode = SizingMode::PRIME;
+    max_load_factor = 0.75f;
+    auto_shrink = false;
+    incremental_rehash = false;
+    old_arr = nullptr;
+    old_size = 0;
+    migrate_pos = 0;
+    // the bucket array waits until the entries outgrow the object
+    new (&small) SmallStorage();
+    real_size = 1;
+    element_arr = &small.bucket;
+    update_thresholds();
 }
 
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::add(key_t key, value_t value){
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::add(const key_t& key, const value_t& value){
+    insert_node(key, value); // does nothing if the key is already here
+}
 
-    // preventing an increase in the chance of collision by enlarging an element array
-    if (HashDict<key_t, value_t>::get_occupancy() > 75)
-        HashDict<key_t, value_t>::create_new_elements_arr();
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename K, typename V>
+void HashDict<key_t, value_t, Hash, KeyEqual>::add(K&& key, V&& value){
+    emplace(std::forward<K>(key), std::forward<V>(value));
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename K, typename... Args>
+std::pair<value_t*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::emplace(K&& key, Args&&... args){
+    if constexpr (std::is_same<typename std::decay<K>::type, key_t>::value)
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    else
+        return try_emplace(key_t(std::forward<K>(key)), std::forward<Args>(args)...);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename... Args>
+std::pair<value_t*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::try_emplace(const key_t& key, Args&&... args){
+    std::pair<ListEl<key_t, value_t>*, bool> result = insert_node(key, std::forward<Args>(args)...);
+    return {&result.first->value, result.second};
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename... Args>
+std::pair<value_t*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::try_emplace(key_t&& key, Args&&... args){
+    std::pair<ListEl<key_t, value_t>*, bool> result = insert_node(std::move(key), std::forward<Args>(args)...);
+    return {&result.first->value, result.second};
+}
 
-    unsigned position = HashDict<key_t, value_t>::getHash(key, real_size);
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename V>
+std::pair<value_t*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::insert_or_assign(const key_t& key, V&& value){
+    std::pair<ListEl<key_t, value_t>*, bool> result = insert_node(key, std::forward<V>(value));
+    // insert_node only consumes the value when it creates a node, so it is still intact here
+    if (!result.second) result.first->value = std::forward<V>(value);
+    return {&result.first->value, result.second};
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename V>
+std::pair<value_t*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::insert_or_assign(key_t&& key, V&& value){
+    std::pair<ListEl<key_t, value_t>*, bool> result = insert_node(std::move(key), std::forward<V>(value));
+    // insert_node only consumes the value when it creates a node, so it is still intact here
+    if (!result.second) result.first->value = std::forward<V>(value);
+    return {&result.first->value, result.second};
+}
 
-    HashDict<key_t, value_t>::element_arr[position].add(key, value);
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::pop(const key_t& key){
+    if (!erase(key)) throw std::logic_error("no such key in the dict!!!");
+}
 
-    HashDict<key_t, value_t>::element_count++;
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool HashDict<key_t, value_t, Hash, KeyEqual>::is_in(const key_t& key){
+    return find(key) != nullptr;
 }
 
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::pop(key_t key){
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+value_t* HashDict<key_t, value_t, Hash, KeyEqual>::find(const key_t& key){
+    HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step();
+    ListEl<key_t, value_t>* element = find_node(key);
+    return element == nullptr ? nullptr : &element->value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+const value_t* HashDict<key_t, value_t, Hash, KeyEqual>::find(const key_t& key) const{
+    // no migration step here: const lookups never modify the table
+    ListEl<key_t, value_t>* element = find_node(key);
+    return element == nullptr ? nullptr : &element->value;
+}
 
-    int position = HashDict<key_t, value_t>::getHash(key, real_size);
-    // if element_arr[i] is not empty, overloaded operator, look to LinkedList.h
-    if (HashDict<key_t, value_t>::element_arr[position] != nullptr){
-        element_arr[position].pop(key);
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::optional<value_t> HashDict<key_t, value_t, Hash, KeyEqual>::try_get(const key_t& key) const{
+    const value_t* value = find(key);
+    if (value == nullptr) return std::nullopt;
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool HashDict<key_t, value_t, Hash, KeyEqual>::erase(const key_t& key){
+
+    if (is_small()){
+        ListEl<key_t, value_t>* element_to_delete = find_small(key);
+        if (element_to_delete == nullptr) return false;
+        erase_small(element_to_delete);
         element_count --;
-    } else{
-        throw std::logic_error("no elements here!!!");
+        return true;
     }
+
+    HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step();
+
+    std::size_t hash = getHash(key);
+    LinkedList_dict<key_t, value_t>* bucket = bucket_for(hash);
+    ListEl<key_t, value_t>* previous_element = nullptr;
+    ListEl<key_t, value_t>* element_to_delete = find_in_bucket(*bucket, key, hash, &previous_element);
+    if (element_to_delete == nullptr) return false;
+
+    bucket->unlink(previous_element, element_to_delete);
+    destroy_node(*bucket, element_to_delete);
+    element_count --;
+
+    // the table became sparse, shrinking it to half full
+    if (element_count < shrink_threshold){
+        long long new_size = fit_size(static_cast<long long>(element_count / max_load_factor * 2));
+        if (new_size < real_size) HashDict<key_t, value_t, Hash, KeyEqual>::rebuild(new_size);
+    }
+    return true;
 }
 
-template<typename key_t,typename value_t>
-bool HashDict<key_t, value_t>::is_in(key_t key){
-    int position = HashDict<key_t, value_t>::getHash(key, real_size);
-    // calling LinkedList func is_in
-    return HashDict<key_t, value_t>::element_arr[position].is_in(key);
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::contains_many(const key_t* keys, std::size_t count, bool* results) const{
+    std::size_t hashes[PREFETCH_GROUP];
+    LinkedList_dict<key_t, value_t>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(keys + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++)
+            results[start + i] = find_in_bucket(*buckets[i], keys[start + i], hashes[i]) != nullptr;
+    }
 }
 
-template<typename key_t,typename value_t>
-value_t& HashDict<key_t, value_t>::operator[](key_t key) {
-    if(!is_in(key)) throw std::logic_error("no such key in the dict!!!");
-    int position = HashDict<key_t, value_t>::getHash(key, real_size);
-    return element_arr[position][key];
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::find_many(const key_t* keys, std::size_t count, value_t** results){
+    std::size_t hashes[PREFETCH_GROUP];
+    LinkedList_dict<key_t, value_t>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        // one migration step per group, so the buckets stay valid while the group is resolved
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step();
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(keys + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++){
+            ListEl<key_t, value_t>* element = find_in_bucket(*buckets[i], keys[start + i], hashes[i]);
+            results[start + i] = element == nullptr ? nullptr : &element->value;
+        }
+    }
 }
 
-template<typename key_t,typename value_t>
-const value_t& HashDict<key_t, value_t>::operator[](key_t key) const{
-    if(!is_in(key)) throw std::logic_error("no such key in the dict!!!");
-    int position = getHash(key, real_size);
-    return element_arr[position][key];
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::find_many(const key_t* keys, std::size_t count, const value_t** results) const{
+    std::size_t hashes[PREFETCH_GROUP];
+    LinkedList_dict<key_t, value_t>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(keys + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++){
+            ListEl<key_t, value_t>* element = find_in_bucket(*buckets[i], keys[start + i], hashes[i]);
+            results[start + i] = element == nullptr ? nullptr : &element->value;
+        }
+    }
 }
 
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::print(std::ostream& out) const {
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::add_many(const key_t* keys, const value_t* values, std::size_t count){
+    // growing once up front, a resize in the middle of a group would waste its prefetches
+    HashDict<key_t, value_t, Hash, KeyEqual>::reserve(static_cast<int>(element_count + count));
+
+    std::size_t hashes[PREFETCH_GROUP];
+    LinkedList_dict<key_t, value_t>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step();
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(keys + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++)
+            insert_hashed(hashes[i], keys[start + i], values[start + i]);
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename RandomIt>
+void HashDict<key_t, value_t, Hash, KeyEqual>::build_parallel(RandomIt begin, RandomIt end, int threads){
+    static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>::value,
+                  "build_parallel needs random access iterators");
+    std::size_t count = static_cast<std::size_t>(end - begin);
+    if (count == 0) return;
+
+    // every node goes straight into its final bucket, so no resize and no migration may follow
+    HashDict<key_t, value_t, Hash, KeyEqual>::finish_rehash();
+    HashDict<key_t, value_t, Hash, KeyEqual>::reserve(static_cast<int>(element_count + count));
+
+    int thread_number = thread_count_for(threads, count);
+    if (thread_number == 1){
+        // nothing to partition for a single thread
+        for (std::size_t i = 0; i < count; i++) insert_hashed(getHash(begin[i].first), begin[i].first, begin[i].second);
+        return;
+    }
+
+    std::vector<std::size_t> hashes, order, starts;
+    partition_by_bucket(count, real_size, sizing_mode, thread_number,
+                        [this, &begin](std::size_t i){ return getHash(begin[i].first); }, hashes, order, starts);
+
+    std::vector<NodePool<ListEl<key_t, value_t>>> pools(thread_number);
+    std::vector<int> added(thread_number, 0);
+    std::exception_ptr error;
+    try {
+        parallel_for(thread_number, [&](int t){
+            int own_added = 0;
+            try {
+                for (std::size_t j = starts[t]; j < starts[t + 1]; j++){
+                    std::size_t i = order[j];
+                    LinkedList_dict<key_t, value_t>& bucket = element_arr[position_of(hashes[i], real_size)];
+                    if (find_in_bucket(bucket, begin[i].first, hashes[i]) != nullptr) continue; // do nothing
+
+                    ListEl<key_t, value_t>* new_el = create_node(pools[t], bucket, begin[i].first, begin[i].second);
+                    if constexpr (should_cache_hash<key_t>::value) new_el -> hash = hashes[i];
+                    bucket.link_front(new_el);
+                    own_added++;
+                }
+            } catch (...) {
+                added[t] = own_added;
+                throw;
+            }
+            added[t] = own_added;
+        });
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // the nodes of every thread are linked already, even if another thread failed
+    for (int t = 0; t < thread_number; t++){
+        pool.merge(pools[t]);
+        element_count += added[t];
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::string HashDict<key_t, value_t, Hash, KeyEqual>::freeze() const{
+    return freeze_entries<key_t, value_t>(element_count, [this](auto&& emit){
+        // the buckets that are still waiting for the migration, then the current ones
+        for (int i = migrate_pos; old_arr != nullptr && i < old_size; i++){
+            for (ListEl<key_t, value_t>* curr_el = old_arr[i].first_el; curr_el != nullptr; curr_el = curr_el->next_pointer)
+                emit(node_hash(curr_el), curr_el->key, curr_el->value);
+        }
+        for (int i = 0; i < real_size; i++){
+            for (ListEl<key_t, value_t>* curr_el = element_arr[i].first_el; curr_el != nullptr; curr_el = curr_el->next_pointer)
+                emit(node_hash(curr_el), curr_el->key, curr_el->value);
+        }
+    });
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::save(const std::string& path) const{
+    write_frozen_file(path, freeze());
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+value_t& HashDict<key_t, value_t, Hash, KeyEqual>::operator[](const key_t& key) {
+    value_t* value = find(key);
+    if(value == nullptr) throw std::logic_error("no such key in the dict!!!");
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+const value_t& HashDict<key_t, value_t, Hash, KeyEqual>::operator[](const key_t& key) const{
+    const value_t* value = find(key);
+    if(value == nullptr) throw std::logic_error("no such key in the dict!!!");
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::print(std::ostream& out) const {
+    // buckets that still wait for migration
+    for (int i = migrate_pos; old_arr != nullptr && i < old_size; i++){
+        if (old_arr[i] == nullptr) continue;
+        out << old_arr[i] << " ";
+    }
     for (int i = 0; i < real_size; i++){
         // if element_arr[i] is empty, overloaded operator, look at LinkedList_dict.h
         if (element_arr[i] == nullptr) continue;
@@ -344,133 +1383,382 @@ void HashDict<key_t, value_t>::print(std::ostream& out) const {
 }
 
 
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::set_incremental_rehash(bool enabled){
+    if (!enabled) finish_rehash();
+    incremental_rehash = enabled;
+}
+
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::set_sizing_mode(SizingMode mode){
+    // the migration must use the mapping the old buckets were built with
+    HashDict<key_t, value_t, Hash, KeyEqual>::finish_rehash();
+    sizing_mode = mode;
+    if (is_small()) return; // a single bucket, the mapping doesn't matter
+
+    long long new_size = real_size;
+    if (mode == SizingMode::POWER_OF_TWO) new_size = fit_size(real_size);
+
+    // every bucket index changes with the mapping, so the table is rebuilt even at the same size
+    HashDict<key_t, value_t, Hash, KeyEqual>::rebuild(new_size);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::reserve(int count){
+    if (is_small() && count <= small_limit()) return;
+    long long needed = static_cast<long long>(std::ceil(count / max_load_factor)) + 1;
+    if (needed > real_size) HashDict<key_t, value_t, Hash, KeyEqual>::rehash(static_cast<int>(needed));
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::rehash(int bucket_count){
+    if (is_small() && bucket_count <= 1) return; // nothing to shrink
+    // never go below what the current elements need
+    long long needed = static_cast<long long>(std::ceil(element_count / max_load_factor)) + 1;
+    if (needed < bucket_count) needed = bucket_count;
+    HashDict<key_t, value_t, Hash, KeyEqual>::rebuild(fit_size(needed));
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::shrink_to_fit(){
+    HashDict<key_t, value_t, Hash, KeyEqual>::rehash(0);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::set_max_load_factor(float factor){
+    if (!(factor > 0)) throw std::logic_error("max load factor must be positive!!!");
+    max_load_factor = factor;
+    HashDict<key_t, value_t, Hash, KeyEqual>::update_thresholds();
+    if (element_count > grow_threshold) HashDict<key_t, value_t, Hash, KeyEqual>::rehash(0);
+}
+
+
 //protected:
 
 
-// hash functions
-template<typename key_t,typename value_t>
-template <typename T>
-typename std::enable_if<std::is_integral<T>::value, long long int>::type
-HashDict<key_t, value_t>::getHash(T value, int size) const {
-    // hash function works only for positive nums
-    if (value < 0) {
-        value = -value;
+// buffer scaling functions
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::update_thresholds(){
+    if (is_small()){
+        // the small mode ends when its slots are full, not at a load factor
+        grow_threshold = small_limit() - 1;
+        shrink_threshold = 0;
+        return;
     }
-    long long int result = 0;
-    while (value) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= (value & 0xFF);
-        value >>= 8;
+    grow_threshold = static_cast<int>(real_size * max_load_factor);
+    shrink_threshold = auto_shrink ? static_cast<int>(real_size * max_load_factor / 4) : 0;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+long long HashDict<key_t, value_t, Hash, KeyEqual>::fit_size(long long bucket_count){
+    long long size = bucket_count < MIN_SIZE ? MIN_SIZE : bucket_count;
+    if (sizing_mode == SizingMode::POWER_OF_TWO){
+        long long power = 1;
+        while (power < size) power *= 2;
+        return power;
+    }
+
+    while (!HashDict<key_t, value_t, Hash, KeyEqual>::is_prime(size)) size++;
+    // the next automatic resize continues after this size, not after the largest one so far
+    curr_pow_for_primes = 0;
+    while ((2LL << curr_pow_for_primes) <= size) curr_pow_for_primes++;
+    return size;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::rebuild(long long new_size){
+    HashDict<key_t, value_t, Hash, KeyEqual>::finish_rehash();
+
+    if (is_small()){
+        // the pool takes the bytes of the small storage, so the entries move out through a pool of their own
+        NodePool<ListEl<key_t, value_t>> moved;
+        LinkedList_dict<key_t, value_t>* new_element_arr = HashDict<key_t, value_t, Hash, KeyEqual>::new_bucket_array(new_size, moved);
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_bucket(small.bucket, new_element_arr, new_size, moved);
+        small.~SmallStorage();
+        new (&pool) NodePool<ListEl<key_t, value_t>>(std::move(moved));
+        element_arr = new_element_arr;
+    } else {
+        LinkedList_dict<key_t, value_t>* new_element_arr = HashDict<key_t, value_t, Hash, KeyEqual>::new_bucket_array(new_size, pool);
+        HashDict<key_t, value_t, Hash, KeyEqual>::copy_list(new_element_arr, new_size);
+        delete[] element_arr;
+        element_arr = new_element_arr;
     }
+    pool.reserve(0);
+    real_size = new_size;
+    HashDict<key_t, value_t, Hash, KeyEqual>::update_thresholds();
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::create_new_elements_arr(){
+        // a new resize can't start before the previous migration is over
+        HashDict<key_t, value_t, Hash, KeyEqual>::finish_rehash();
+
+        if (is_small()){
+            // leaving the small mode at once, half full, the few entries aren't worth a migration
+            HashDict<key_t, value_t, Hash, KeyEqual>::rebuild(fit_size(static_cast<long long>(element_count / max_load_factor * 2)));
+            return;
+        }
+
+        long long new_size = HashDict<key_t, value_t, Hash, KeyEqual>::next_size();
+
+        LinkedList_dict<key_t, value_t>* new_element_arr = HashDict<key_t, value_t, Hash, KeyEqual>::new_bucket_array(new_size, pool);
 
-    return result % size;
+        if (incremental_rehash){
+            // old buckets are moved later, a few per operation
+            old_arr = element_arr;
+            old_size = real_size;
+            migrate_pos = 0;
+        } else {
+            HashDict<key_t, value_t, Hash, KeyEqual>::copy_list(new_element_arr, new_size);
+            delete[] HashDict<key_t, value_t, Hash, KeyEqual>::element_arr;
+            pool.reserve(0);
+        }
+
+        element_arr = new_element_arr;
+        HashDict<key_t, value_t, Hash, KeyEqual>::real_size = new_size;
+        HashDict<key_t, value_t, Hash, KeyEqual>::update_thresholds();
 }
 
-template<typename key_t,typename value_t>
-template <typename T>
-typename std::enable_if<std::is_floating_point<T>::value, long long int>::type
-HashDict<key_t, value_t>::getHash(T value, int size) const {
-    long long int result = 0;
-    unsigned char* bytePtr = reinterpret_cast<unsigned char*>(&value);
-    for (size_t i = 0; i < sizeof(T); ++i) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= bytePtr[i];
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::copy_list(LinkedList_dict<key_t, value_t>* new_arr, int new_size){
+    // running through all buckets
+    for (int i = 0; i < real_size; i ++){
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_bucket(element_arr[i], new_arr, new_size, pool);
     }
+}
 
-    return result % size;
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::size_t HashDict<key_t, value_t, Hash, KeyEqual>::relocation_count(int new_size){
+    std::size_t count = 0;
+    if constexpr (LinkedList_dict<key_t, value_t>::INLINE || SMALL_CAPACITY > 0){
+        std::vector<bool> taken(LinkedList_dict<key_t, value_t>::INLINE ? new_size : 0);
+        for (int i = 0; i < real_size; i++){
+            // only the small bucket has more than one such node, the others are read without the chain
+            ListEl<key_t, value_t>* curr_el = is_small() ? element_arr[i].first_el : element_arr[i].inline_node();
+            for (; curr_el != nullptr; curr_el = is_small() ? curr_el->next_pointer : nullptr){
+                if (!element_arr[i].owns_inline(curr_el) && !in_small_nodes(curr_el)) continue;
+                if constexpr (LinkedList_dict<key_t, value_t>::INLINE){
+                    int position = HashDict<key_t, value_t, Hash, KeyEqual>::position_of(node_hash(curr_el), new_size);
+                    if (!taken[position]){
+                        taken[position] = true;
+                        continue;
+                    }
+                }
+                count++;
+            }
+        }
+    }
+    return count;
 }
 
-template<typename key_t,typename value_t>
-template <typename T>
-typename std::enable_if<std::is_pointer<T>::value, long long int>::type
-HashDict<key_t, value_t>::getHash(T value, int size) const {
-    long long int result = 0;
-    uintptr_t ptr = reinterpret_cast<uintptr_t>(value);
-    unsigned char* bytePtr = reinterpret_cast<unsigned char*>(&ptr);
-    for (size_t i = 0; i < sizeof(ptr); ++i) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= bytePtr[i];
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+LinkedList_dict<key_t, value_t>* HashDict<key_t, value_t, Hash, KeyEqual>::new_bucket_array(long long new_size, NodePool<ListEl<key_t, value_t>>& into){
+    LinkedList_dict<key_t, value_t>* new_arr = new LinkedList_dict<key_t, value_t>[new_size];
+    try {
+        into.reserve(HashDict<key_t, value_t, Hash, KeyEqual>::relocation_count(static_cast<int>(new_size)));
+    } catch (...) {
+        delete[] new_arr;
+        throw;
     }
-    return result % size;
+    return new_arr;
 }
 
-template<typename key_t,typename value_t>
-long long int HashDict<key_t, value_t>::getHash(const std::string& value, int size) const{
-    long long int result = 0;
-    for (char c : value) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= static_cast<unsigned char>(c);
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step(){
+    if (old_arr == nullptr) return;
+
+    for (int i = 0; i < REHASH_STEP && migrate_pos < old_size; i++, migrate_pos++){
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_bucket(old_arr[migrate_pos], element_arr, real_size, pool);
+    }
+
+    if (migrate_pos == old_size){
+        delete[] old_arr;
+        old_arr = nullptr;
+        old_size = 0;
+        migrate_pos = 0;
+        pool.reserve(0);
     }
-    return result % size;
 }
 
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::finish_rehash(){
+    if (old_arr == nullptr) return;
 
-// buffer scaling functions
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::add_to_array(LinkedList_dict<key_t, value_t>* arr,int arr_size, key_t key, value_t value){
-    int position = HashDict<key_t, value_t>::getHash(key, arr_size);
-    // in fact LinkedList.add(key, value)
-    arr[position].add(key, value);
+    for (; migrate_pos < old_size; migrate_pos++){
+        HashDict<key_t, value_t, Hash, KeyEqual>::migrate_bucket(old_arr[migrate_pos], element_arr, real_size, pool);
+    }
+    delete[] old_arr;
+    old_arr = nullptr;
+    old_size = 0;
+    migrate_pos = 0;
+    pool.reserve(0);
 }
 
-template<typename key_t,typename value_t>
-float HashDict<key_t, value_t>::get_occupancy(){
-    if (real_size == 0) return 0;
-    return ((float)element_count / real_size) * 100;
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+LinkedList_dict<key_t, value_t>* HashDict<key_t, value_t, Hash, KeyEqual>::bucket_for(std::size_t hash) const{
+    if (old_arr != nullptr){
+        int old_position = HashDict<key_t, value_t, Hash, KeyEqual>::position_of(hash, old_size);
+        if (old_position >= migrate_pos) return &old_arr[old_position];
+    }
+    return &element_arr[HashDict<key_t, value_t, Hash, KeyEqual>::position_of(hash, real_size)];
 }
 
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::create_new_elements_arr(){
-        long long new_size = HashDict<key_t, value_t>::next_prime();
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+ListEl<key_t, value_t>* HashDict<key_t, value_t, Hash, KeyEqual>::find_in_bucket(const LinkedList_dict<key_t, value_t>& bucket, const key_t& key, std::size_t hash,
+                                                                                ListEl<key_t, value_t>** previous_element) const{
+    if (is_small()) return find_small(key);
+
+    ListEl<key_t, value_t>* previous = nullptr;
+    ListEl<key_t, value_t>* curr_el = bucket.first_el;
+    while (curr_el != nullptr){
+        bool candidate = true;
+        if constexpr (should_cache_hash<key_t>::value) candidate = curr_el->hash == hash;
+        if (candidate && key_equal(curr_el->key, key)){
+            if (previous_element != nullptr) *previous_element = previous;
+            return curr_el;
+        }
+        previous = curr_el;
+        curr_el = curr_el->next_pointer;
+    }
+    return nullptr;
+}
 
-        LinkedList_dict<key_t, value_t>* new_element_arr = new LinkedList_dict<key_t, value_t>[new_size];
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename K, typename... Args>
+std::pair<ListEl<key_t, value_t>*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::insert_node(K&& key, Args&&... args){
 
-        HashDict<key_t, value_t>::copy_list(new_element_arr, new_size);
+    // preventing an increase in the chance of collision by enlarging an element array
+    if (element_count > grow_threshold)
+        HashDict<key_t, value_t, Hash, KeyEqual>::create_new_elements_arr();
 
-        delete[] HashDict<key_t, value_t>::element_arr;
-        element_arr = new_element_arr;
-        HashDict<key_t, value_t>::real_size = new_size;
+    HashDict<key_t, value_t, Hash, KeyEqual>::migrate_step();
+
+    // the small mode finds keys without their hash
+    std::size_t hash = is_small() ? 0 : getHash(key);
+    return insert_hashed(hash, std::forward<K>(key), std::forward<Args>(args)...);
 }
 
-template<typename key_t,typename value_t>
-void HashDict<key_t, value_t>::copy_list(LinkedList_dict<key_t, value_t>* new_arr, int new_size){
-    // running through all buckets
-    for (int i = 0; i < real_size; i ++){
-        // if there is at least one element |look at the LinkedList_dict|
-        if (element_arr[i] != nullptr){
-            // for all element in linked list
-            for (int j = 0; j < element_arr[i].get_size(); j++){
-                Couple<key_t, value_t> c = element_arr[i].get_couple(j);
-                add_to_array(new_arr, new_size, c.key, c.value);
-            }
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+ListEl<key_t, value_t>* HashDict<key_t, value_t, Hash, KeyEqual>::find_small(const key_t& key) const{
+    if constexpr (SMALL_CAPACITY > 0){
+        for (int i = 0; i < small.bucket.size; i++){
+            ListEl<key_t, value_t>* curr_el = small.nodes.at(i);
+            if (key_equal(curr_el->key, key)) return curr_el;
+        }
+    }
+    return nullptr;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::erase_small(ListEl<key_t, value_t>* node){
+    // the chain runs from the newest node down to nodes[0], so the newest one is the last slot in use
+    ListEl<key_t, value_t>* last = small.bucket.first_el;
+    if (node != last){
+        ListEl<key_t, value_t>* next = node->next_pointer;
+        small.nodes.destroy(node);
+        small.nodes.construct(static_cast<int>(node - small.nodes.at(0)), std::move(last->key), std::move(last->value));
+        node->next_pointer = next;
+    }
+    small.bucket.first_el = last->next_pointer;
+    small.bucket.size--;
+    small.nodes.destroy(last);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename K, typename... Args>
+std::pair<ListEl<key_t, value_t>*, bool> HashDict<key_t, value_t, Hash, KeyEqual>::insert_hashed(std::size_t hash, K&& key, Args&&... args){
+    LinkedList_dict<key_t, value_t>* bucket = bucket_for(hash);
+    ListEl<key_t, value_t>* found = find_in_bucket(*bucket, key, hash);
+    if (found != nullptr) return {found, false};
+
+    ListEl<key_t, value_t>* new_el = create_node(pool, *bucket, std::forward<K>(key), std::forward<Args>(args)...);
+    if constexpr (should_cache_hash<key_t>::value) new_el -> hash = hash;
+    bucket->link_front(new_el);
+
+    HashDict<key_t, value_t, Hash, KeyEqual>::element_count++;
+    return {new_el, true};
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::prefetch_group(const key_t* keys, std::size_t count, std::size_t* hashes,
+                                                              LinkedList_dict<key_t, value_t>** buckets) const{
+    for (std::size_t i = 0; i < count; i++){
+        hashes[i] = getHash(keys[i]);
+        buckets[i] = bucket_for(hashes[i]);
+        prefetch(buckets[i]);
+    }
+    // the buckets are on their way, now the heads of the chains
+    for (std::size_t i = 0; i < count; i++) prefetch(buckets[i]->first_el);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::destroy_nodes(LinkedList_dict<key_t, value_t>* arr, int size){
+    for (int i = 0; arr != nullptr && i < size; i++){
+        ListEl<key_t, value_t>* curr_el = arr[i].first_el;
+        while (curr_el != nullptr){
+            ListEl<key_t, value_t>* next = curr_el->next_pointer;
+            destroy_node(arr[i], curr_el);
+            curr_el = next;
         }
+        arr[i].first_el = nullptr;
+        arr[i].size = 0;
     }
+}
 
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void HashDict<key_t, value_t, Hash, KeyEqual>::migrate_bucket(LinkedList_dict<key_t, value_t>& bucket, LinkedList_dict<key_t, value_t>* new_arr, int new_size,
+                                                              NodePool<ListEl<key_t, value_t>>& into){
+    ListEl<key_t, value_t>* curr_el = bucket.first_el;
+    // relinking every node of the chain, keys are already unique
+    while (curr_el != nullptr){
+        ListEl<key_t, value_t>* next = curr_el->next_pointer;
+        std::size_t hash = node_hash(curr_el);
+        int position = HashDict<key_t, value_t, Hash, KeyEqual>::position_of(hash, new_size);
+        if constexpr (LinkedList_dict<key_t, value_t>::INLINE || SMALL_CAPACITY > 0){
+            // an inline or small node can't outlive its storage, the pool slots for it are reserved
+            if (bucket.owns_inline(curr_el) || in_small_nodes(curr_el)){
+                ListEl<key_t, value_t>* moved = nullptr;
+                if constexpr (LinkedList_dict<key_t, value_t>::INLINE){
+                    if (new_arr[position].inline_free()) moved = new_arr[position].construct_inline(std::move(curr_el->key), std::move(curr_el->value));
+                }
+                if (moved == nullptr) moved = into.create_reserved(std::move(curr_el->key), std::move(curr_el->value));
+                if constexpr (should_cache_hash<key_t>::value) moved -> hash = hash;
+                destroy_node(bucket, curr_el);
+                curr_el = moved;
+            }
+        }
+        new_arr[position].link_front(curr_el);
+        curr_el = next;
+    }
+    // the nodes belong to new_arr now, the old list must not delete them
+    bucket.first_el = nullptr;
+    bucket.size = 0;
 }
 
-template<typename key_t,typename value_t>
-long long HashDict<key_t, value_t>::next_prime(){
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+long long HashDict<key_t, value_t, Hash, KeyEqual>::next_prime(){
     long long min_lim = pow(2, curr_pow_for_primes);
     long long max_lim = pow(2, curr_pow_for_primes+1);
 
     long long middle = (min_lim + max_lim) / 2;
     for (long long i = middle; i < max_lim - 1; i++){
-        if (HashDict<key_t, value_t>::is_prime(middle - i)){
+        if (HashDict<key_t, value_t, Hash, KeyEqual>::is_prime(middle - i)){
             curr_pow_for_primes ++;
             return middle - i;
         }
-        if (HashDict<key_t, value_t>::is_prime(middle + i)){
+        if (HashDict<key_t, value_t, Hash, KeyEqual>::is_prime(middle + i)){
             curr_pow_for_primes ++;
             return middle + i;
         }
     }
     // if no primes from 2^k-1 to 2^k;
     curr_pow_for_primes ++;
-    return HashDict<key_t, value_t>::next_prime();
+    return HashDict<key_t, value_t, Hash, KeyEqual>::next_prime();
 }
 
-template<typename key_t,typename value_t>
-bool HashDict<key_t, value_t>::is_prime(long long num){
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool HashDict<key_t, value_t, Hash, KeyEqual>::is_prime(long long num){
         if (num < 2) return false;
         if (num == 2 || num == 3) return true;
         if (num % 2 == 0 || num % 3 == 0) return false;
@@ -0,0 +1,67 @@
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#ifndef LEARNING_HASHPOLICY_H
+#define LEARNING_HASHPOLICY_H
+
+
+/**
+ * @brief The way HashDict and HashSet choose their bucket count and map hashes to buckets.
+ */
+enum class SizingMode {
+    PRIME,          /**< Prime bucket counts, a hash is mapped with a modulo. */
+    POWER_OF_TWO    /**< Power-of-two bucket counts, a hash is mapped with a multiply and a shift. */
+};
+
+
+/**
+ * @brief Maps a hash to a bucket index.
+ *
+ * In PRIME mode this is a plain modulo. In POWER_OF_TWO mode the hash is first spread with a
+ * Fibonacci multiply (by 2^64 / phi) and then reduced with Lemire's fastrange, which for a
+ * power-of-two size simply keeps the top bits of the mixed hash. No division is involved.
+ * The extra multiply keeps the mapping usable with user hashes that only vary in their low bits.
+ *
+ * @param hash The hash of the key.
+ * @param size The number of buckets, at most 2^31 - 1.
+ * @param mode The sizing mode of the table.
+ * @return int The bucket index in [0, size).
+ */
+inline int map_to_bucket(uint64_t hash, int size, SizingMode mode){
+    uint64_t h = hash;
+    if (mode == SizingMode::PRIME) return static_cast<int>(h % static_cast<uint64_t>(size));
+
+    h *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<int>(((h >> 32) * static_cast<uint64_t>(size)) >> 32);
+}
+
+
+/**
+ * @brief The number of keys the batched APIs (contains_many, find_many, add_many) handle per group.
+ *
+ * All keys of a group are hashed and their buckets prefetched before the first of them is
+ * resolved, so up to this many cache misses are in flight at once.
+ */
+const int PREFETCH_GROUP = 16;
+
+/**
+ * @brief Hints the CPU to start loading the cache line at the given address.
+ *
+ * Does nothing on compilers without a prefetch intrinsic. Never faults, even for nullptr.
+ *
+ * @param address The address to prefetch.
+ */
+inline void prefetch(const void* address){
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+#endif //LEARNING_HASHPOLICY_H
@@ -0,0 +1,240 @@
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <functional>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#ifndef LEARNING_HASHING_H
+#define LEARNING_HASHING_H
+
+
+/**
+ * @brief Mixes all bits of a 64-bit value into all bits of the result.
+ *
+ * This is the splitmix64 finalizer: two multiply-xorshift rounds, so that keys that differ
+ * in a single bit end up with unrelated hashes.
+ *
+ * @param x The value to mix.
+ * @return uint64_t The mixed value.
+ */
+constexpr uint64_t mix64(uint64_t x){
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Computes the full 128-bit product of two 64-bit values.
+ *
+ * @param a The first factor, replaced with the low half of the product.
+ * @param b The second factor, replaced with the high half of the product.
+ */
+inline void mul128(uint64_t& a, uint64_t& b){
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t low = t + (rm1 << 32);
+    carry += low < t;
+    a = low;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+/**
+ * @brief Multiplies two 64-bit values and folds the 128-bit product into 64 bits.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @return uint64_t The low half of the product xor-ed with the high half.
+ */
+inline uint64_t mum64(uint64_t a, uint64_t b){
+    mul128(a, b);
+    return a ^ b;
+}
+
+/**
+ * @brief Hashes a byte string.
+ *
+ * A wyhash-style hash: the input is consumed 16 or 48 bytes at a time with 64x64->128 bit
+ * multiplications, short inputs are read with at most four overlapping loads.
+ *
+ * @param data Pointer to the bytes.
+ * @param len The number of bytes.
+ * @param seed The hash seed.
+ * @return uint64_t The hash of the bytes.
+ */
+inline uint64_t hash_bytes(const void* data, std::size_t len, uint64_t seed = 0){
+    static const uint64_t secret[4] = {0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL,
+                                       0x4B33A62ED433D4A3ULL, 0x4D5A2DA51DE1AA47ULL};
+    auto read8 = [](const uint8_t* p){ uint64_t v; std::memcpy(&v, p, 8); return v; };
+    auto read4 = [](const uint8_t* p){ uint32_t v; std::memcpy(&v, p, 4); return static_cast<uint64_t>(v); };
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed ^= mum64(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+
+    if (len <= 16){
+        if (len >= 4){
+            a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0){
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t i = len;
+        if (i > 48){
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mum64(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                see1 = mum64(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                see2 = mum64(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16){
+            seed = mum64(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    mul128(a, b);
+    return mum64(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+/**
+ * @brief Combines the hash of one more field into a running hash.
+ *
+ * Meant for user-defined hashes of composite keys.
+ *
+ * Example:
+ * @code
+ * struct PointHash {
+ *     std::size_t operator()(const Point& p) const {
+ *         return hash_combine(DefaultHash<int>()(p.x), DefaultHash<int>()(p.y));
+ *     }
+ * };
+ * @endcode
+ *
+ * @param seed The running hash.
+ * @param hash The hash of the next field.
+ * @return std::size_t The combined hash.
+ */
+inline std::size_t hash_combine(std::size_t seed, std::size_t hash){
+    return static_cast<std::size_t>(mix64(seed ^ (hash + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2))));
+}
+
+
+/**
+ * @brief The default Hash parameter of the hash structures.
+ *
+ * Integers, enums and pointers go through the mix64 finalizer, floating-point numbers hash
+ * their bit pattern (with -0.0 folded into 0.0) and strings use hash_bytes. Any other type
+ * falls back to std::hash, whose result is mixed the same way. Specialize DefaultHash or pass
+ * your own Hash functor to support other key types.
+ *
+ * @tparam T The type of the key.
+ */
+template<typename T, typename Enable = void>
+struct DefaultHash {
+    std::size_t operator()(const T& value) const {
+        return static_cast<std::size_t>(mix64(static_cast<uint64_t>(std::hash<T>()(value))));
+    }
+};
+
+template<typename T>
+struct DefaultHash<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type> {
+    std::size_t operator()(T value) const {
+        return static_cast<std::size_t>(mix64(static_cast<uint64_t>(value)));
+    }
+};
+
+template<typename T>
+struct DefaultHash<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    std::size_t operator()(T value) const {
+        // 0.0 == -0.0, so both must hash the same
+        if (value == 0) value = 0;
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T) < sizeof(bits) ? sizeof(T) : sizeof(bits));
+        return static_cast<std::size_t>(mix64(bits));
+    }
+};
+
+template<typename T>
+struct DefaultHash<T, typename std::enable_if<std::is_pointer<T>::value>::type> {
+    std::size_t operator()(T value) const {
+        return static_cast<std::size_t>(mix64(reinterpret_cast<uintptr_t>(value)));
+    }
+};
+
+template<>
+struct DefaultHash<std::string> {
+    std::size_t operator()(std::string_view value) const {
+        return static_cast<std::size_t>(hash_bytes(value.data(), value.size()));
+    }
+};
+
+template<>
+struct DefaultHash<std::string_view> {
+    std::size_t operator()(std::string_view value) const {
+        return static_cast<std::size_t>(hash_bytes(value.data(), value.size()));
+    }
+};
+
+
+
+/**
+ * @brief Decides whether chain nodes keep the full hash of their key.
+ *
+ * With a cached hash, a lookup compares hashes before comparing keys and a resize never
+ * hashes a key again. This pays off for keys that are expensive to hash or compare, such
+ * as strings, so it is on for every key type except arithmetic, enum and pointer ones.
+ * Specialize it to override the choice for a particular key type.
+ *
+ * @tparam T The type of the key.
+ */
+template<typename T>
+struct should_cache_hash : std::integral_constant<bool, !std::is_arithmetic<T>::value &&
+                                                        !std::is_enum<T>::value &&
+                                                        !std::is_pointer<T>::value> {};
+
+/**
+ * @brief The part of a chain node that holds the cached hash, empty when caching is off.
+ *
+ * @tparam enabled Whether the hash is cached.
+ */
+template<bool enabled>
+struct HashCache {
+    std::size_t hash;    /**< The full hash of the key stored in the node. */
+};
+
+template<>
+struct HashCache<false> {};
+
+#endif //LEARNING_HASHING_H
@@ -3,6 +3,11 @@
 //
 #include <stdexcept>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Hashing.h"
 
 #ifndef LEARNING_LINKEDLIST_DICT_H
 #define LEARNING_LINKEDLIST_DICT_H
@@ -11,17 +16,63 @@
 /**
  * @brief A structure representing a node in the linked list for HashDict.
  *
+ * When should_cache_hash<key_type> holds, the node also keeps the full hash of its key,
+ * which HashDict fills in and uses to skip key comparisons and rehashing.
+ *
  * @tparam key_type The type of the key stored in the node.
  * @tparam value_type The type of the value stored in the node.
  */
 template<typename key_type, typename value_type>
-struct ListEl{
-    bool is_empty;                                 /**< Flag indicating if the node is empty (actually useless). */
+struct ListEl : HashCache<should_cache_hash<key_type>::value>{
     key_type key;                                  /**< The key stored in the node. */
     value_type value;                              /**< The value associated with the key. */
     ListEl<key_type, value_type>* next_pointer;    /**< Pointer to the next node in the list. */
+
+    ListEl() = default;
+
+    /**
+     * @brief Constructs a node in place from a key and the constructor arguments of the value.
+     *
+     * @param node_key The key, copied or moved into the node.
+     * @param args Arguments forwarded to the constructor of the value.
+     */
+    template<typename K, typename... Args>
+    explicit ListEl(K&& node_key, Args&&... args) : key(std::forward<K>(node_key)), value(std::forward<Args>(args)...),
+                                                    next_pointer(nullptr) {}
+};
+
+
+/**
+ * @brief Decides whether a HashDict bucket keeps its first entry inline.
+ *
+ * With the entry inline, a lookup that hits the first entry of a chain reads only the bucket
+ * array and skips the pointer hop to a separately allocated node. The cost is room for one
+ * entry in every bucket, used or not, so it is on only for nodes of up to 32 bytes whose key
+ * and value move without throwing. Specialize it to override the choice for a particular pair.
+ *
+ * @tparam key_type The type of the key.
+ * @tparam value_type The type of the value.
+ */
+template<typename key_type, typename value_type>
+struct should_inline_first : std::integral_constant<bool, sizeof(ListEl<key_type, value_type>) <= 32 &&
+                                                          std::is_nothrow_move_constructible<key_type>::value &&
+                                                          std::is_nothrow_move_constructible<value_type>::value> {};
+
+/**
+ * @brief Room for one node inside a bucket, empty when inline entries are off.
+ *
+ * @tparam node_type The type of the node.
+ * @tparam enabled Whether the bucket has the room.
+ */
+template<typename node_type, bool enabled>
+struct InlineSlot {
+    alignas(node_type) unsigned char storage[sizeof(node_type)];    /**< The bytes of the inline node. */
+    bool used = false;                                             /**< Whether a node lives in storage. */
 };
 
+template<typename node_type>
+struct InlineSlot<node_type, false> {};
+
 
 /**
  * @brief A structure representing a key-value pair.
@@ -42,12 +93,17 @@ struct Couple{
  * Provides functionality to add, check, and remove key-value pairs.
  * Supports access to values by key and iteration through the list.
  *
+ * When should_inline_first holds, the list also has room for one node of its own, which
+ * HashDict uses for the first entry of the bucket. Nodes added through add() always live
+ * on the heap.
+ *
  * @tparam key_type The type of keys stored in the linked list.
  * @tparam value_type The type of values associated with the keys.
  */
 template<typename key_type, typename value_type>
-class LinkedList_dict {
+class LinkedList_dict : InlineSlot<ListEl<key_type, value_type>, should_inline_first<key_type, value_type>::value> {
 private:
+    static constexpr bool INLINE = should_inline_first<key_type, value_type>::value;    /**< Whether the list has an inline node. */
 
     int size;                                /**< The number of key-value pairs in the list. */
     ListEl<key_type, value_type>* first_el;  /**< Pointer to the first element in the list. */
@@ -222,15 +278,109 @@ protected:
      */
     void find_element_with_key(key_type key, ListEl<key_type, value_type>*& previous_element, ListEl<key_type, value_type>*& element_to_delete) const;
 
+    /**
+     * @brief Links an existing node in front of the list.
+     *
+     * Used when rehashing: the node is moved as it is, without allocation, copying or a duplicate check.
+     *
+     * @param node The node to link, it must not belong to any list.
+     */
+    void link_front(ListEl<key_type, value_type>* node){
+        node->next_pointer = first_el;
+        first_el = node;
+        size++;
+    }
 
-    template <typename T>
-    friend class HashSet;
+    /**
+     * @brief Unlinks a node from the list without deleting it.
+     *
+     * @param previous_element The node before the one to unlink, nullptr if it is the first one.
+     * @param node The node to unlink.
+     */
+    void unlink(ListEl<key_type, value_type>* previous_element, ListEl<key_type, value_type>* node){
+        if (previous_element == nullptr) first_el = node->next_pointer;
+        else previous_element->next_pointer = node->next_pointer;
+        size--;
+    }
 
-    template<typename key_t, typename value_t>
+    /**
+     * @brief Checks whether the inline node is free for a new entry.
+     */
+    bool inline_free() const {
+        if constexpr (INLINE) return !this->used;
+        else return false;
+    }
+
+    /**
+     * @brief Checks whether a node is the inline node of this list.
+     */
+    bool owns_inline(const ListEl<key_type, value_type>* node) const {
+        if constexpr (INLINE) return this->used && node == reinterpret_cast<const ListEl<key_type, value_type>*>(this->storage);
+        else return false;
+    }
+
+    /**
+     * @brief The inline node, or nullptr while it is free.
+     */
+    ListEl<key_type, value_type>* inline_node(){
+        if constexpr (INLINE) return this->used ? std::launder(reinterpret_cast<ListEl<key_type, value_type>*>(this->storage)) : nullptr;
+        else return nullptr;
+    }
+
+    /**
+     * @brief Constructs the inline node, it must be free. The node is not linked yet.
+     *
+     * @param args Arguments forwarded to the constructor of the node.
+     * @return ListEl<key_type, value_type>* The inline node.
+     */
+    template<typename... Args>
+    ListEl<key_type, value_type>* construct_inline(Args&&... args){
+        ListEl<key_type, value_type>* node = new (this->storage) ListEl<key_type, value_type>(std::forward<Args>(args)...);
+        this->used = true;
+        return node;
+    }
+
+    /**
+     * @brief Destroys the inline node, which must be unlinked already.
+     */
+    void destroy_inline(){
+        if constexpr (INLINE){
+            std::launder(reinterpret_cast<ListEl<key_type, value_type>*>(this->storage))->~ListEl();
+            this->used = false;
+        }
+    }
+
+
+    template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
     friend class HashDict;
 }; // End of the class
 
 
+/**
+ * @brief The number of entries a HashDict keeps in an array inside itself before it hashes.
+ *
+ * A new HashDict stores its first entries packed in an array of nodes in the object and finds
+ * them by comparing keys one after another, without hashing. The array shares its bytes with
+ * the node pool of a hashed dict. The default is as many nodes as fit in 192 bytes, but never
+ * fewer than 4 or more than 8, so an int to int dict holds 8 entries and a std::string one 4.
+ * It is 0 for keys or values that may throw while moving, as leaving the small mode moves them.
+ * Specialize it to change the number for a particular pair.
+ *
+ * @tparam key_type The type of the key.
+ * @tparam value_type The type of the value.
+ */
+template<typename key_type, typename value_type>
+struct small_dict_capacity {
+    static constexpr int count(){
+        if (!std::is_nothrow_move_constructible<key_type>::value || !std::is_nothrow_move_constructible<value_type>::value) return 0;
+        std::size_t nodes = 192 / sizeof(ListEl<key_type, value_type>);
+        return nodes < 4 ? 4 : nodes > 8 ? 8 : static_cast<int>(nodes);
+    }
+
+    static constexpr int value = count();    /**< The number of entries. */
+};
+
+
 // public
 
 template<typename key_type, typename value_type>
@@ -239,7 +389,8 @@ LinkedList_dict<key_type, value_type>::~LinkedList_dict(){
     while (curr_el != nullptr){
 
         ListEl<key_type, value_type>* next = curr_el->next_pointer;
-        delete curr_el;
+        if (owns_inline(curr_el)) destroy_inline();
+        else delete curr_el;
         curr_el = next;
     }
 }
@@ -253,7 +404,6 @@ void LinkedList_dict<key_type, value_type>::add(key_type key, value_type value){
     new_el -> key = key;
     new_el -> value = value;
     new_el -> next_pointer = nullptr;
-    new_el ->is_empty = false;
     if (size == 0){
         first_el = new_el;
     } else {
@@ -277,7 +427,7 @@ bool LinkedList_dict<key_type, value_type>::is_in(key_type key){
 
         ListEl<key_type, value_type>* curr_el = first_el;
         while (curr_el != nullptr){
-            if (curr_el->key == key && !curr_el->is_empty) return true;
+            if (curr_el->key == key) return true;
             curr_el = curr_el->next_pointer;
         }
         return false;
@@ -319,7 +469,7 @@ const value_type& LinkedList_dict<key_type, value_type>::operator[](key_type key
 
         ListEl<key_type, value_type>* curr_el = first_el;
         while (curr_el != nullptr){
-            if (curr_el->key == key && !curr_el->is_empty) return curr_el ->value;
+            if (curr_el->key == key) return curr_el ->value;
             curr_el = curr_el->next_pointer;
         }
         throw std::logic_error("no element here!!!");
@@ -334,7 +484,7 @@ value_type& LinkedList_dict<key_type, value_type>::operator[](key_type key){
 
         ListEl<key_type, value_type>* curr_el = first_el;
         while (curr_el != nullptr){
-            if (curr_el->key == key && !curr_el->is_empty) return curr_el ->value;
+            if (curr_el->key == key) return curr_el ->value;
             curr_el = curr_el->next_pointer;
         }
         throw std::logic_error("no element here!!!");
@@ -386,7 +536,7 @@ void LinkedList_dict<key_type, value_type>::find_element_with_key(key_type key,
     ListEl<key_type, value_type>* curr_el = first_el;
 
     while (curr_el != nullptr){
-        if (curr_el->key == key && !curr_el->is_empty){
+        if (curr_el->key == key){
             element_to_delete = curr_el;
             break;
         }
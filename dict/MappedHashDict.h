@@ -0,0 +1,242 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FrozenFormat.h"
+#include "HashPolicy.h"
+#include "Hashing.h"
+
+#ifndef LEARNING_MAPPEDHASHDICT_H
+#define LEARNING_MAPPEDHASHDICT_H
+
+
+/**
+ * @brief A read-only view of a frozen HashDict, answering lookups straight from the image.
+ *
+ * The image is written by HashDict::freeze() or HashDict::save(). Opening a file maps it with
+ * mmap, so nothing is parsed or copied: the pages are loaded by the OS on first use and shared
+ * between all processes that map the same file. find() returns pointers into the mapping, or a
+ * std::string_view for string values, which stay valid while the MappedHashDict lives.
+ *
+ * The Hash must give the same results as the one that froze the dict, in every process.
+ * DefaultHash does; std::hash is not guaranteed to.
+ *
+ * Example:
+ * @code
+ * HashDict<std::string, int> dict;
+ * dict.add("one", 1);
+ * dict.save("numbers.frozen");
+ *
+ * MappedHashDict<std::string, int> mapped("numbers.frozen");
+ * const int* one = mapped.find("one");
+ * @endcode
+ *
+ * @tparam key_t The type of keys, trivially copyable or std::string.
+ * @tparam value_t The type of values, trivially copyable or std::string.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ */
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>>
+class MappedHashDict {
+protected:
+    using entry_type = FrozenEntry<key_t, value_t>;
+    using find_type = typename FrozenCodec<value_t>::find_type;
+
+    const char* data;                /**< The first byte of the image. */
+    std::size_t size;                /**< The size of the image. */
+    bool owns_mapping;               /**< Whether data was mapped by this object and must be unmapped. */
+
+    const FrozenHeader* header;      /**< The header of the image. */
+    const uint64_t* offsets;         /**< The bucket offsets, bucket_count + 1 of them. */
+    const entry_type* entries;       /**< The entries, grouped by bucket. */
+    const char* blob;                /**< The string bytes. */
+
+    Hash hasher;                     /**< The hash functor. */
+
+public:
+    /**
+     * @brief Maps a file written by HashDict::save().
+     *
+     * @param path The path of the file.
+     * @param hash The hash functor to use.
+     * @throws std::logic_error If the file cannot be mapped or is not a valid frozen dict of these types.
+     */
+    explicit MappedHashDict(const std::string& path, const Hash& hash = Hash());
+
+    /**
+     * @brief Reads an image that is already in memory, for example the result of HashDict::freeze().
+     *
+     * The memory is not copied and must outlive the MappedHashDict. It must be aligned to 8 bytes,
+     * which memory from new, malloc and std::string always is.
+     *
+     * @param image The first byte of the image.
+     * @param image_size The size of the image.
+     * @param hash The hash functor to use.
+     * @throws std::logic_error If the image is not a valid frozen dict of these types.
+     */
+    MappedHashDict(const char* image, std::size_t image_size, const Hash& hash = Hash());
+
+    /**
+     * @brief Destructor.
+     *
+     * Unmaps the file if the dict was opened from one.
+     */
+    ~MappedHashDict(){
+        if (owns_mapping) munmap(const_cast<char*>(data), size);
+    }
+
+    MappedHashDict(const MappedHashDict&) = delete;
+    MappedHashDict& operator=(const MappedHashDict&) = delete;
+
+    /**
+     * @brief Looks up the value of a key.
+     *
+     * @param key The key to look for.
+     * @return find_type A pointer to the value, or a std::string_view for string values; nullptr or std::nullopt if absent.
+     */
+    find_type find(const key_t& key) const;
+
+    /**
+     * @brief Checks if a key is in the MappedHashDict.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false If it is not.
+     */
+    bool is_in(const key_t& key) const {
+        return static_cast<bool>(find(key));
+    }
+
+    /**
+     * @brief Retrieves the number of key-value pairs.
+     *
+     * @return std::size_t The count of pairs.
+     */
+    [[nodiscard]] std::size_t getSize() const {
+        return static_cast<std::size_t>(header->entry_count);
+    }
+
+    /**
+     * @brief Retrieves the number of buckets.
+     *
+     * @return std::size_t The bucket count.
+     */
+    [[nodiscard]] std::size_t getTrueSize() const {
+        return static_cast<std::size_t>(header->bucket_count);
+    }
+
+protected:
+    /**
+     * @brief Checks the header and the sections of the image and sets the section pointers.
+     *
+     * @throws std::logic_error If anything points outside the image or the types do not match.
+     */
+    void validate();
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename value_t, typename Hash>
+MappedHashDict<key_t, value_t, Hash>::MappedHashDict(const std::string& path, const Hash& hash)
+        : data(nullptr), size(0), owns_mapping(false), header(nullptr), offsets(nullptr), entries(nullptr), blob(nullptr), hasher(hash) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::logic_error("can't open the file!!!");
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0){
+        close(fd);
+        throw std::logic_error("can't read the file!!!");
+    }
+    size = static_cast<std::size_t>(info.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) throw std::logic_error("can't map the file!!!");
+    data = static_cast<const char*>(mapping);
+    owns_mapping = true;
+
+    try {
+        MappedHashDict<key_t, value_t, Hash>::validate();
+    } catch (...) {
+        munmap(mapping, size);
+        throw;
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash>
+MappedHashDict<key_t, value_t, Hash>::MappedHashDict(const char* image, std::size_t image_size, const Hash& hash)
+        : data(image), size(image_size), owns_mapping(false), header(nullptr), offsets(nullptr), entries(nullptr), blob(nullptr), hasher(hash) {
+    MappedHashDict<key_t, value_t, Hash>::validate();
+}
+
+template<typename key_t, typename value_t, typename Hash>
+typename MappedHashDict<key_t, value_t, Hash>::find_type MappedHashDict<key_t, value_t, Hash>::find(const key_t& key) const{
+    uint64_t hash = static_cast<uint64_t>(hasher(key));
+    int bucket = map_to_bucket(hash, static_cast<int>(header->bucket_count), SizingMode::POWER_OF_TWO);
+
+    for (uint64_t i = offsets[bucket]; i < offsets[bucket + 1]; i++){
+        const entry_type& entry = entries[i];
+        if (entry.hash == hash && FrozenCodec<key_t>::matches(entry.key, blob, key))
+            return FrozenCodec<value_t>::found(entry.value, blob);
+    }
+    return FrozenCodec<value_t>::missing();
+}
+
+
+//protected:
+
+template<typename key_t, typename value_t, typename Hash>
+void MappedHashDict<key_t, value_t, Hash>::validate(){
+    if (reinterpret_cast<uintptr_t>(data) % 8 != 0) throw std::logic_error("the frozen dict isn't aligned!!!");
+    if (size < sizeof(FrozenHeader)) throw std::logic_error("this isn't a frozen dict!!!");
+    header = reinterpret_cast<const FrozenHeader*>(data);
+
+    if (std::memcmp(header->magic, "HDFROZEN", 8) != 0) throw std::logic_error("this isn't a frozen dict!!!");
+    if (header->version != FROZEN_VERSION) throw std::logic_error("unsupported frozen dict version!!!");
+    if (header->byte_order != FROZEN_BYTE_ORDER) throw std::logic_error("the frozen dict has another byte order!!!");
+    if (header->key_tag != FrozenCodec<key_t>::TAG || header->value_tag != FrozenCodec<value_t>::TAG)
+        throw std::logic_error("the frozen dict holds other types!!!");
+
+    // every section must lie inside the image, in order; an offset is checked against the size
+    // before anything is added to it, and the added lengths are below the size, so nothing wraps
+    uint64_t buckets = header->bucket_count;
+    uint64_t count = header->entry_count;
+    bool sizes_ok = buckets != 0 && (buckets & (buckets - 1)) == 0 && buckets <= (1ULL << 30)
+                    && count <= size / sizeof(entry_type)
+                    && header->file_size == size
+                    && header->offsets_offset >= sizeof(FrozenHeader) && header->offsets_offset % 8 == 0
+                    && header->offsets_offset <= size && header->entries_offset <= size
+                    && header->entries_offset >= header->offsets_offset + (buckets + 1) * sizeof(uint64_t) && header->entries_offset % 8 == 0
+                    && header->blob_offset >= header->entries_offset + count * sizeof(entry_type)
+                    && header->blob_offset <= size;
+    if (!sizes_ok) throw std::logic_error("the frozen dict is damaged!!!");
+
+    offsets = reinterpret_cast<const uint64_t*>(data + header->offsets_offset);
+    entries = reinterpret_cast<const entry_type*>(data + header->entries_offset);
+    blob = data + header->blob_offset;
+
+    // the bucket offsets must grow and end at the entry count, so a lookup only visits real entries
+    if (offsets[0] != 0 || offsets[buckets] != count) throw std::logic_error("the frozen dict is damaged!!!");
+    for (uint64_t b = 0; b < buckets; b++){
+        if (offsets[b] > offsets[b + 1]) throw std::logic_error("the frozen dict is damaged!!!");
+    }
+
+    // and every string of an entry must lie inside the blob, so a lookup reads nothing past the image
+    uint64_t blob_size = size - header->blob_offset;
+    for (uint64_t i = 0; i < count; i++){
+        if (!FrozenCodec<key_t>::fits(entries[i].key, blob_size) || !FrozenCodec<value_t>::fits(entries[i].value, blob_size))
+            throw std::logic_error("the frozen dict is damaged!!!");
+    }
+}
+
+#endif //LEARNING_MAPPEDHASHDICT_H
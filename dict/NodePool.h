@@ -0,0 +1,425 @@
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#ifndef LEARNING_NODEPOOL_H
+#define LEARNING_NODEPOOL_H
+
+
+/**
+ * @brief A slab allocator for the chain nodes of HashDict and HashSet.
+ *
+ * Nodes are carved out of chunks instead of being allocated one by one, and a freed
+ * node is pushed onto a free list that the next create() reuses first. The first chunk holds
+ * a single node and every next chunk is twice as large as the last one (up to MAX_CHUNK), so
+ * a table of n elements makes only O(log n) calls to the global allocator, while a pool that
+ * serves a handful of nodes never holds more than twice the memory they need.
+ *
+ * Every chunk starts with a one-word header that links it to the previous chunk, so an empty
+ * pool is seven words and allocates nothing. Chunks are released only when the pool itself is destroyed. The pool never runs node
+ * destructors on its own: the owner must destroy() every node it created before that.
+ *
+ * @tparam Node The type of the nodes.
+ */
+template<typename Node>
+class NodePool {
+protected:
+    /**
+     * @brief Storage for one node, reused as a free list link while the node is free.
+     */
+    union Slot {
+        Slot* next_free;                                      /**< The next free slot. */
+        alignas(Node) unsigned char storage[sizeof(Node)];    /**< Raw storage for a node. */
+    };
+
+    /**
+     * @brief The start of a chunk, its slots follow at CHUNK_HEADER bytes.
+     */
+    struct Chunk {
+        Chunk* previous;    /**< The chunk allocated before this one. */
+    };
+
+    static const std::size_t FIRST_CHUNK = 1;       /**< The number of slots in the first chunk. */
+    static const std::size_t MAX_CHUNK = 1 << 16;   /**< The largest number of slots in a chunk. */
+    /** The size of the chunk header, rounded up so that the slots after it stay aligned. */
+    static const std::size_t CHUNK_HEADER = (sizeof(Chunk) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+    Chunk* chunks;                 /**< The last chunk allocated. */
+    Slot* free_list;               /**< Freed slots, most recently freed first. */
+    Slot* bump;                    /**< The next never-used slot of the last chunk. */
+    Slot* bump_end;                /**< The end of the last chunk. */
+    std::size_t next_chunk;        /**< The number of slots in the next chunk. */
+    std::size_t free_count;        /**< The length of free_list. */
+    std::size_t reserved;          /**< The free slots set aside for create_reserved(), create() leaves them alone. */
+
+public:
+    /**
+     * @brief Default constructor. No memory is allocated until the first create().
+     */
+    NodePool() : chunks(nullptr), free_list(nullptr), bump(nullptr), bump_end(nullptr), next_chunk(FIRST_CHUNK), free_count(0), reserved(0) {}
+
+    /**
+     * @brief Destructor.
+     *
+     * Frees all chunks. Nodes that are still alive are not destroyed.
+     */
+    ~NodePool(){
+        release();
+    }
+
+    /**
+     * @brief Move constructor. Takes over all storage of other, which is left empty.
+     *
+     * @param other The pool to move from.
+     */
+    NodePool(NodePool&& other) noexcept
+            : chunks(other.chunks), free_list(other.free_list), bump(other.bump), bump_end(other.bump_end), next_chunk(other.next_chunk),
+              free_count(other.free_count), reserved(other.reserved) {
+        other.chunks = nullptr;
+        other.free_list = other.bump = other.bump_end = nullptr;
+        other.next_chunk = FIRST_CHUNK;
+        other.free_count = 0;
+        other.reserved = 0;
+    }
+
+    /**
+     * @brief Move assignment. Frees the chunks of this pool, whose nodes must be destroyed
+     * already, and takes over all storage of other, which is left empty.
+     *
+     * @param other The pool to move from.
+     * @return NodePool& This pool.
+     */
+    NodePool& operator=(NodePool&& other) noexcept {
+        if (&other == this) return *this;
+        release();
+        chunks = other.chunks;
+        free_list = other.free_list;
+        bump = other.bump;
+        bump_end = other.bump_end;
+        next_chunk = other.next_chunk;
+        free_count = other.free_count;
+        reserved = other.reserved;
+        other.chunks = nullptr;
+        other.free_list = other.bump = other.bump_end = nullptr;
+        other.next_chunk = FIRST_CHUNK;
+        other.free_count = 0;
+        other.reserved = 0;
+        return *this;
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * @brief Constructs a node in pooled storage.
+     *
+     * @param args Arguments forwarded to the constructor of the node.
+     * @return Node* The new node.
+     */
+    template<typename... Args>
+    Node* create(Args&&... args);
+
+    /**
+     * @brief Constructs a node in one of the slots set aside by reserve().
+     *
+     * Never allocates, so the only way it can throw is the constructor of the node. Falls back
+     * to create() if nothing is reserved.
+     *
+     * @param args Arguments forwarded to the constructor of the node.
+     * @return Node* The new node.
+     */
+    template<typename... Args>
+    Node* create_reserved(Args&&... args);
+
+    /**
+     * @brief Destroys a node and gives its storage back to the pool.
+     *
+     * @param node A node created by this pool.
+     */
+    void destroy(Node* node);
+
+    /**
+     * @brief Takes over all storage of another pool.
+     *
+     * The nodes created by other belong to this pool afterwards and must be destroyed through
+     * it. Its free and never-used slots join the free list of this pool, its reservation doesn't
+     * carry over. other is left empty. This is how nodes built by several threads, each with
+     * its own pool, end up in one table.
+     *
+     * @param other The pool to take over.
+     */
+    void merge(NodePool& other);
+
+    /**
+     * @brief Sets aside count free slots for create_reserved(), allocating them if needed.
+     *
+     * HashDict calls it before a step that must not fail halfway, such as moving nodes out
+     * of storage that is about to go away. create() doesn't touch the reserved slots, so other
+     * nodes created meanwhile can't use them up. The new reservation replaces the previous
+     * one, and reserve(0) gives the unused slots back to create().
+     *
+     * @param count The number of nodes.
+     */
+    void reserve(std::size_t count);
+
+
+protected:
+    /**
+     * @brief The number of slots create() can use without allocating, reserved ones included.
+     */
+    std::size_t available() const {
+        return free_count + static_cast<std::size_t>(bump_end - bump);
+    }
+
+    /**
+     * @brief Takes a slot from the free list or from the current chunk, without checking the reservation.
+     *
+     * @return Slot* Uninitialized storage for one node, the pool must have one available.
+     */
+    Slot* pop_slot();
+
+    /**
+     * @brief Takes a slot that isn't reserved, allocating a chunk if there is none.
+     *
+     * @return Slot* Uninitialized storage for one node.
+     */
+    Slot* take_slot();
+
+    /**
+     * @brief Moves the never-used slots of the current chunk to the free list.
+     */
+    void retire_bump();
+
+    /**
+     * @brief Allocates a chunk and makes it the one never-used slots are taken from.
+     *
+     * Every next chunk is at least twice as large as this one, so a chunk sized by reserve()
+     * keeps the growth geometric.
+     *
+     * @param size The number of slots.
+     */
+    void add_chunk(std::size_t size);
+
+    /**
+     * @brief Frees every chunk, leaving the pool empty.
+     */
+    void release(){
+        while (chunks != nullptr){
+            Chunk* previous = chunks->previous;
+            ::operator delete(chunks);
+            chunks = previous;
+        }
+        free_list = bump = bump_end = nullptr;
+        next_chunk = FIRST_CHUNK;
+        free_count = 0;
+        reserved = 0;
+    }
+}; // End of the class
+
+
+
+/**
+ * @brief A fixed array of node slots kept inside the owning object.
+ *
+ * The small mode of HashDict keeps its entries here, packed at the front of the array, so a
+ * dict with a few entries makes no allocation at all and a lookup is a linear scan of one
+ * block of memory. The owner keeps count of the used slots, the array only hands them out by index.
+ *
+ * @tparam Node The type of the nodes.
+ * @tparam N The number of slots; 0 gives an empty object without any.
+ */
+template<typename Node, int N>
+class SmallNodes {
+protected:
+    // the nodes don't belong to the constness of the owner, the same as nodes in a pool
+    alignas(Node) mutable unsigned char storage[N][sizeof(Node)];   /**< The slots. */
+
+public:
+    SmallNodes() = default;
+
+    SmallNodes(const SmallNodes&) = delete;
+    SmallNodes& operator=(const SmallNodes&) = delete;
+
+    /**
+     * @brief The node in a slot that holds one.
+     *
+     * @param index The slot index.
+     * @return Node* The node.
+     */
+    Node* at(int index) const {
+        return std::launder(reinterpret_cast<Node*>(storage[index]));
+    }
+
+    /**
+     * @brief Checks whether a node lives in one of the slots.
+     */
+    bool owns(const Node* node) const {
+        const unsigned char* address = reinterpret_cast<const unsigned char*>(node);
+        return address >= storage[0] && address < storage[0] + sizeof(storage);
+    }
+
+    /**
+     * @brief Constructs a node in a free slot.
+     *
+     * @param index The slot index.
+     * @param args Arguments forwarded to the constructor of the node.
+     * @return Node* The new node.
+     */
+    template<typename... Args>
+    Node* construct(int index, Args&&... args){
+        return ::new (static_cast<void*>(storage[index])) Node(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destroys a node of these slots, leaving its slot free.
+     *
+     * @param node The node.
+     */
+    void destroy(Node* node){
+        node->~Node();
+    }
+}; // End of the class
+
+template<typename Node>
+class SmallNodes<Node, 0> {
+public:
+    bool owns(const Node*) const {
+        return false;
+    }
+
+    void destroy(Node*){}
+};
+
+
+
+// methods implementation
+
+//public:
+
+template<typename Node>
+template<typename... Args>
+Node* NodePool<Node>::create(Args&&... args){
+    Slot* slot = take_slot();
+    try {
+        return ::new (static_cast<void*>(slot->storage)) Node(std::forward<Args>(args)...);
+    } catch (...) {
+        slot->next_free = free_list;
+        free_list = slot;
+        free_count++;
+        throw;
+    }
+}
+
+template<typename Node>
+template<typename... Args>
+Node* NodePool<Node>::create_reserved(Args&&... args){
+    if (reserved == 0) return create(std::forward<Args>(args)...);
+
+    Slot* slot = pop_slot();
+    reserved--;
+    try {
+        return ::new (static_cast<void*>(slot->storage)) Node(std::forward<Args>(args)...);
+    } catch (...) {
+        slot->next_free = free_list;
+        free_list = slot;
+        free_count++;
+        reserved++;
+        throw;
+    }
+}
+
+template<typename Node>
+void NodePool<Node>::destroy(Node* node){
+    node->~Node();
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next_free = free_list;
+    free_list = slot;
+    free_count++;
+}
+
+template<typename Node>
+void NodePool<Node>::merge(NodePool& other){
+    if (&other == this) return;
+    if (other.chunks != nullptr){
+        Chunk* oldest = other.chunks;
+        while (oldest->previous != nullptr) oldest = oldest->previous;
+        oldest->previous = chunks;
+        chunks = other.chunks;
+        other.chunks = nullptr;
+    }
+
+    while (other.free_list != nullptr){
+        Slot* slot = other.free_list;
+        other.free_list = slot->next_free;
+        slot->next_free = free_list;
+        free_list = slot;
+    }
+    free_count += other.free_count;
+    // the rest of the other pool's last chunk would be lost otherwise
+    for (; other.bump != other.bump_end; other.bump++){
+        other.bump->next_free = free_list;
+        free_list = other.bump;
+        free_count++;
+    }
+
+    other.bump = other.bump_end = nullptr;
+    other.next_chunk = FIRST_CHUNK;
+    other.free_count = 0;
+    other.reserved = 0;
+}
+
+template<typename Node>
+void NodePool<Node>::reserve(std::size_t count){
+    if (available() < count){
+        // the rest of the current chunk goes to the free list, the new chunk covers the difference
+        retire_bump();
+        add_chunk(count - free_count > next_chunk ? count - free_count : next_chunk);
+    }
+    reserved = count;
+}
+
+
+//protected:
+
+template<typename Node>
+typename NodePool<Node>::Slot* NodePool<Node>::pop_slot(){
+    if (free_list != nullptr){
+        Slot* slot = free_list;
+        free_list = slot->next_free;
+        free_count--;
+        return slot;
+    }
+    return bump++;
+}
+
+template<typename Node>
+typename NodePool<Node>::Slot* NodePool<Node>::take_slot(){
+    if (available() <= reserved){
+        // every slot left is reserved, the free list keeps them and a new chunk serves create()
+        retire_bump();
+        add_chunk(next_chunk);
+    }
+    return pop_slot();
+}
+
+template<typename Node>
+void NodePool<Node>::retire_bump(){
+    for (; bump != bump_end; bump++){
+        bump->next_free = free_list;
+        free_list = bump;
+        free_count++;
+    }
+}
+
+template<typename Node>
+void NodePool<Node>::add_chunk(std::size_t size){
+    unsigned char* memory = static_cast<unsigned char*>(::operator new(CHUNK_HEADER + size * sizeof(Slot)));
+    Chunk* chunk = ::new (static_cast<void*>(memory)) Chunk{chunks};
+    chunks = chunk;
+    bump = reinterpret_cast<Slot*>(memory + CHUNK_HEADER);
+    bump_end = bump + size;
+    std::size_t grown = (size > next_chunk ? size : next_chunk) * 2;
+    next_chunk = grown < MAX_CHUNK ? grown : MAX_CHUNK;
+}
+
+#endif //LEARNING_NODEPOOL_H
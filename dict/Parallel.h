@@ -0,0 +1,123 @@
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "HashPolicy.h"
+
+#ifndef LEARNING_PARALLEL_H
+#define LEARNING_PARALLEL_H
+
+
+/**
+ * @brief The smallest amount of input worth giving to one more thread in the parallel bulk operations.
+ */
+const std::size_t PARALLEL_MIN_CHUNK = 4096;
+
+
+/**
+ * @brief Chooses the number of threads for a bulk operation over count items.
+ *
+ * @param requested The requested number of threads, 0 or less for one per hardware thread.
+ * @param count The number of items.
+ * @return int At least 1, and never so many that a thread gets less than PARALLEL_MIN_CHUNK items.
+ */
+inline int thread_count_for(int requested, std::size_t count){
+    std::size_t threads = requested > 0 ? static_cast<std::size_t>(requested) : std::thread::hardware_concurrency();
+    std::size_t useful = count / PARALLEL_MIN_CHUNK;
+    if (threads > useful) threads = useful;
+    return threads < 1 ? 1 : static_cast<int>(threads);
+}
+
+
+/**
+ * @brief Runs function(t) for every t in [0, threads), each call on its own thread.
+ *
+ * The calling thread runs function(0) itself, so a single thread costs no thread start.
+ * If calls throw, all threads are still joined and the first exception is rethrown.
+ *
+ * @param threads The number of calls.
+ * @param function Called as function(int).
+ */
+template<typename F>
+void parallel_for(int threads, F&& function){
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto run = [&](int t){
+        try {
+            function(t);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads > 1 ? threads - 1 : 0);
+    for (int t = 1; t < threads; t++) workers.emplace_back(run, t);
+    run(0);
+    for (std::thread& worker : workers) worker.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+
+/**
+ * @brief Hashes count items in parallel and groups their indices by bucket range.
+ *
+ * The buckets [0, size) are cut into threads contiguous ranges. Afterwards the indices of
+ * range p are order[starts[p]] ... order[starts[p + 1] - 1], in input order, so one thread
+ * per range can fill its buckets without touching any other thread's buckets.
+ *
+ * @param count The number of items.
+ * @param size The number of buckets.
+ * @param mode The sizing mode that maps hashes to buckets.
+ * @param threads The number of threads and of bucket ranges.
+ * @param hash_of Called as hash_of(std::size_t index), returns the hash of an item. Must be thread-safe.
+ * @param hashes Output, the hash of every item.
+ * @param order Output, the item indices grouped by bucket range.
+ * @param starts Output, threads + 1 offsets into order.
+ */
+template<typename HashOf>
+void partition_by_bucket(std::size_t count, int size, SizingMode mode, int threads, HashOf&& hash_of,
+                         std::vector<std::size_t>& hashes, std::vector<std::size_t>& order, std::vector<std::size_t>& starts){
+    hashes.resize(count);
+    order.resize(count);
+    starts.assign(threads + 1, 0);
+    // counts[t * threads + p] is the number of items of input slice t that fall into bucket range p
+    std::vector<std::size_t> counts(static_cast<std::size_t>(threads) * threads, 0);
+
+    auto range_of = [size, mode, threads](std::size_t hash){
+        return static_cast<int>(static_cast<long long>(map_to_bucket(hash, size, mode)) * threads / size);
+    };
+
+    parallel_for(threads, [&](int t){
+        std::size_t from = count * t / threads, to = count * (t + 1) / threads;
+        std::size_t* own_counts = &counts[static_cast<std::size_t>(t) * threads];
+        for (std::size_t i = from; i < to; i++){
+            hashes[i] = hash_of(i);
+            own_counts[range_of(hashes[i])]++;
+        }
+    });
+
+    // turning the counts into write offsets: range by range, and inside a range slice by slice
+    std::size_t offset = 0;
+    for (int p = 0; p < threads; p++){
+        starts[p] = offset;
+        for (int t = 0; t < threads; t++){
+            std::size_t items = counts[static_cast<std::size_t>(t) * threads + p];
+            counts[static_cast<std::size_t>(t) * threads + p] = offset;
+            offset += items;
+        }
+    }
+    starts[threads] = offset;
+
+    parallel_for(threads, [&](int t){
+        std::size_t from = count * t / threads, to = count * (t + 1) / threads;
+        std::size_t* own_offsets = &counts[static_cast<std::size_t>(t) * threads];
+        for (std::size_t i = from; i < to; i++) order[own_offsets[range_of(hashes[i])]++] = i;
+    });
+}
+
+#endif //LEARNING_PARALLEL_H
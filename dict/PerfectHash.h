@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "Hashing.h"
+
+#ifndef LEARNING_PERFECTHASH_H
+#define LEARNING_PERFECTHASH_H
+
+
+/**
+ * @brief A minimal perfect hash function of a fixed key set, built PTHash-style (Pibiri, Trani).
+ *
+ * After build(), index_of() maps each of the n keys to its own index in [0, n) with no
+ * collisions. Keys outside the set are mapped to some index too, so the containers on top of
+ * it (PerfectHashDict, PerfectHashSet) compare the stored key to reject them.
+ *
+ * Keys are split into about n / 4 small buckets, 60% of them into the first 30% of buckets.
+ * Every bucket gets a 16-bit pilot, found by trying 0, 1, 2, ... until all keys of the bucket
+ * land on free places of a table with n / 0.99 slots. Buckets are placed largest first, so
+ * the hard work happens while the table is still empty. The few keys that land past n are
+ * redirected to the free places below n through a small remap array.
+ *
+ * The function itself takes about 4.3 bits per key: one pilot per 4 keys and a 32-bit remap
+ * entry per 100 keys. A lookup is two hash mixes, one pilot read and a multiply.
+ *
+ * @tparam key_t The type of keys.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, used to report duplicate keys while building.
+ */
+template<typename key_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
+class PerfectHash {
+protected:
+    static constexpr double KEYS_PER_BUCKET = 4.0;     /**< The average bucket size. */
+    static constexpr double LOAD_FACTOR = 0.99;        /**< The share of table slots below n. */
+    static constexpr double DENSE_KEYS = 0.6;          /**< The share of keys that go to the dense buckets... */
+    static constexpr double DENSE_BUCKETS = 0.3;       /**< ...and the share of buckets they go to. */
+    static const int MAX_SEEDS = 32;                   /**< Seeds tried before the build gives up. */
+
+    std::size_t key_count;               /**< n, the number of keys. */
+    std::size_t table_size;              /**< The number of slots the pilots place keys into, at least n. */
+    std::size_t bucket_count;            /**< The number of buckets, one pilot each. */
+    std::size_t dense_count;             /**< The number of dense buckets. */
+    uint64_t dense_threshold;            /**< Hashes below it go to the dense buckets. */
+    uint64_t seed;                       /**< Mixed into every key hash, changed when a build fails. */
+
+    std::vector<uint16_t> pilots;        /**< The pilot of every bucket. */
+    std::vector<uint32_t> remap;         /**< The index below n of every slot past n that holds a key. */
+
+    Hash hasher;                         /**< The hash functor. */
+    KeyEqual key_equal;                  /**< The key comparison functor. */
+
+public:
+    /**
+     * @brief Constructor of an empty function, build() gives it keys.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
+     */
+    explicit PerfectHash(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : key_count(0), table_size(0), bucket_count(0), dense_count(0), dense_threshold(0), seed(0),
+              hasher(hash), key_equal(equal) {}
+
+    /**
+     * @brief Builds the function for a set of keys, replacing the old one.
+     *
+     * @param count The number of keys.
+     * @param key_at key_at(i) returns the i-th key, for i in [0, count).
+     * @throws std::logic_error If two keys are equal, or no pilots are found for any seed. The
+     *         function is left empty then, whatever it held before.
+     */
+    template<typename KeyAt>
+    void build(std::size_t count, KeyAt&& key_at);
+
+    /**
+     * @brief Maps a key to its index.
+     *
+     * @param key The key.
+     * @return std::size_t The index of the key in [0, n), unique for every key of the set. Other keys get any index in [0, n).
+     */
+    std::size_t index_of(const key_t& key) const {
+        if (key_count == 0) return 0;
+        uint64_t hash = key_hash(key);
+        std::size_t slot = slot_of(hash, pilots[bucket_of(hash)]);
+        return slot < key_count ? slot : remap[slot - key_count];
+    }
+
+    /**
+     * @brief Retrieves the number of keys.
+     *
+     * @return std::size_t n.
+     */
+    [[nodiscard]] std::size_t getSize() const {
+        return key_count;
+    }
+
+    /**
+     * @brief Retrieves the memory used by the function, without the keys.
+     *
+     * @return std::size_t The number of bytes.
+     */
+    [[nodiscard]] std::size_t memory_size() const {
+        return pilots.size() * sizeof(uint16_t) + remap.size() * sizeof(uint32_t);
+    }
+
+
+protected:
+    uint64_t key_hash(const key_t& key) const {
+        return mix64(static_cast<uint64_t>(hasher(key)) ^ seed);
+    }
+
+    /**
+     * @brief Maps a 64-bit value to [0, range) with a multiply instead of a division.
+     */
+    static std::size_t reduce(uint64_t value, std::size_t range){
+        uint64_t high = range;
+        mul128(value, high);
+        return static_cast<std::size_t>(high);
+    }
+
+    /**
+     * @brief The bucket of a key: the high bits choose dense or sparse, the low bits the bucket inside.
+     */
+    std::size_t bucket_of(uint64_t hash) const {
+        uint64_t rotated = (hash << 32) | (hash >> 32);
+        if (hash < dense_threshold) return reduce(rotated, dense_count);
+        return dense_count + reduce(rotated, bucket_count - dense_count);
+    }
+
+    std::size_t slot_of(uint64_t hash, uint16_t pilot) const {
+        return reduce(mix64(hash ^ mix64(pilot + 1)), table_size);
+    }
+
+    /**
+     * @brief One build attempt with the current seed.
+     *
+     * @return false If some bucket has no free pilot or two different keys share a hash.
+     */
+    template<typename KeyAt>
+    bool try_build(KeyAt& key_at);
+
+    /**
+     * @brief Makes the function empty again, as after the constructor.
+     */
+    void reset(){
+        key_count = table_size = bucket_count = dense_count = 0;
+        pilots.clear();
+        remap.clear();
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename Hash, typename KeyEqual>
+template<typename KeyAt>
+void PerfectHash<key_t, Hash, KeyEqual>::build(std::size_t count, KeyAt&& key_at){
+    if (count > UINT32_MAX) throw std::logic_error("too many keys for the perfect hash!!!");
+    key_count = count;
+    table_size = count == 0 ? 0 : std::max(count, static_cast<std::size_t>(count / LOAD_FACTOR) + 1);
+    bucket_count = static_cast<std::size_t>(count / KEYS_PER_BUCKET) + 1;
+    dense_count = std::max<std::size_t>(1, static_cast<std::size_t>(bucket_count * DENSE_BUCKETS));
+    if (dense_count == bucket_count) dense_threshold = UINT64_MAX;
+    else dense_threshold = static_cast<uint64_t>(DENSE_KEYS * 18446744073709551616.0);
+
+    try {
+        for (int attempt = 0; attempt < MAX_SEEDS; attempt++){
+            seed = mix64(0x9E3779B97F4A7C15ULL * (attempt + 1));
+            if (PerfectHash<key_t, Hash, KeyEqual>::try_build(key_at)) return;
+        }
+    } catch (...) {
+        // a duplicate key or a failed allocation leaves an empty function, not a half-built one
+        PerfectHash<key_t, Hash, KeyEqual>::reset();
+        throw;
+    }
+    PerfectHash<key_t, Hash, KeyEqual>::reset();
+    throw std::logic_error("can't build the perfect hash!!!");
+}
+
+
+//protected:
+
+template<typename key_t, typename Hash, typename KeyEqual>
+template<typename KeyAt>
+bool PerfectHash<key_t, Hash, KeyEqual>::try_build(KeyAt& key_at){
+    std::size_t n = key_count;
+    pilots.assign(bucket_count, 0);
+    remap.clear();
+    if (n == 0) return true;
+
+    // the keys grouped by bucket with a counting sort
+    std::vector<uint64_t> hashes(n);
+    std::vector<uint32_t> starts(bucket_count + 1, 0);
+    for (std::size_t i = 0; i < n; i++){
+        hashes[i] = key_hash(key_at(i));
+        starts[bucket_of(hashes[i]) + 1]++;
+    }
+    for (std::size_t b = 0; b < bucket_count; b++) starts[b + 1] += starts[b];
+    std::vector<uint32_t> members(n);
+    {
+        std::vector<uint32_t> next(starts.begin(), starts.end() - 1);
+        for (std::size_t i = 0; i < n; i++) members[next[bucket_of(hashes[i])]++] = static_cast<uint32_t>(i);
+    }
+
+    // the buckets, largest first
+    std::vector<uint32_t> order(bucket_count);
+    for (std::size_t b = 0; b < bucket_count; b++) order[b] = static_cast<uint32_t>(b);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+        return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+    });
+
+    std::vector<bool> taken(table_size, false);
+    std::vector<std::size_t> slots;
+    for (uint32_t bucket : order){
+        uint32_t begin = starts[bucket], end = starts[bucket + 1];
+        if (begin == end) break; // the rest are empty
+
+        // equal hashes always collide: a duplicate key or a seed to change
+        std::sort(members.begin() + begin, members.begin() + end, [&](uint32_t a, uint32_t b){ return hashes[a] < hashes[b]; });
+        for (uint32_t i = begin + 1; i < end; i++){
+            if (hashes[members[i]] != hashes[members[i - 1]]) continue;
+            if (key_equal(key_at(members[i]), key_at(members[i - 1]))) throw std::logic_error("the key is already here!!!");
+            return false;
+        }
+
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot <= UINT16_MAX && !placed; pilot++){
+            slots.clear();
+            placed = true;
+            for (uint32_t i = begin; i < end && placed; i++){
+                std::size_t slot = slot_of(hashes[members[i]], static_cast<uint16_t>(pilot));
+                placed = !taken[slot] && std::find(slots.begin(), slots.end(), slot) == slots.end();
+                slots.push_back(slot);
+            }
+            if (placed) pilots[bucket] = static_cast<uint16_t>(pilot);
+        }
+        if (!placed) return false;
+        for (std::size_t slot : slots) taken[slot] = true;
+    }
+
+    // the keys past n move to the holes below n, in order
+    remap.assign(table_size - n, 0);
+    std::size_t hole = 0;
+    for (std::size_t slot = n; slot < table_size; slot++){
+        if (!taken[slot]) continue;
+        while (taken[hole]) hole++;
+        remap[slot - n] = static_cast<uint32_t>(hole++);
+    }
+    return true;
+}
+
+#endif //LEARNING_PERFECTHASH_H
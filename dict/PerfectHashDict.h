@@ -0,0 +1,163 @@
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "PerfectHash.h"
+
+#ifndef LEARNING_PERFECTHASHDICT_H
+#define LEARNING_PERFECTHASHDICT_H
+
+
+/**
+ * @brief An immutable dictionary over a minimal perfect hash.
+ *
+ * Built once from a finished HashDict or any range of key-value pairs, then only read. The
+ * keys and the values sit in two packed arrays of exactly n elements, in the order given by
+ * a PerfectHash, so find() is one probe with no chains, no empty slots and no collisions:
+ * the key at the index of the probed key is compared and its value returned.
+ *
+ * Example:
+ * @code
+ * HashDict<std::string, int> dict;
+ * ...
+ * PerfectHashDict<std::string, int> frozen(dict);
+ * const int* value = frozen.find("key");
+ * @endcode
+ *
+ * @tparam key_t The type of keys.
+ * @tparam value_t The type of values.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, std::equal_to<key_t> by default.
+ */
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
+class PerfectHashDict {
+protected:
+    PerfectHash<key_t, Hash, KeyEqual> function;    /**< Maps every key to its index. */
+    std::vector<key_t> keys;                        /**< The keys, keys[function.index_of(key)] == key. */
+    std::vector<value_t> values;                    /**< The values, at the indexes of their keys. */
+    KeyEqual key_equal;                             /**< The key comparison functor. */
+
+public:
+    /**
+     * @brief Builds the dictionary from a range of key-value pairs.
+     *
+     * The elements may be std::pair, DictEntry or anything else that unpacks into a key and a
+     * value with a structured binding.
+     *
+     * @param begin The first pair.
+     * @param end Past the last pair.
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
+     * @throws std::logic_error If a key repeats.
+     */
+    template<typename InputIt>
+    PerfectHashDict(InputIt begin, InputIt end, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Builds the dictionary from a HashDict or another container of key-value pairs.
+     *
+     * @param dict The container, iterated once.
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
+     * @throws std::logic_error If a key repeats.
+     */
+    template<typename Container>
+    explicit PerfectHashDict(const Container& dict, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : PerfectHashDict(std::begin(dict), std::end(dict), hash, equal) {}
+
+    /**
+     * @brief Looks up the value of a key.
+     *
+     * @param key The key to look for.
+     * @return const value_t* Pointer to the value, or nullptr if the key is absent.
+     */
+    const value_t* find(const key_t& key) const {
+        if (keys.empty()) return nullptr;
+        std::size_t index = function.index_of(key);
+        return key_equal(keys[index], key) ? &values[index] : nullptr;
+    }
+
+    /**
+     * @brief Same as find() const, but the value can be changed in place.
+     */
+    value_t* find(const key_t& key){
+        return const_cast<value_t*>(static_cast<const PerfectHashDict*>(this)->find(key));
+    }
+
+    /**
+     * @brief Retrieves the value of a key.
+     *
+     * @param key The key to look for.
+     * @return const value_t& The value.
+     * @throws std::logic_error If the key is absent.
+     */
+    const value_t& operator[](const key_t& key) const {
+        const value_t* value = find(key);
+        if (value == nullptr) throw std::logic_error("no such key in the dict!!!");
+        return *value;
+    }
+
+    /**
+     * @brief Checks if a key is in the PerfectHashDict.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false If it is not.
+     */
+    bool is_in(const key_t& key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief Retrieves the number of key-value pairs.
+     *
+     * @return std::size_t The count of pairs.
+     */
+    [[nodiscard]] std::size_t getSize() const {
+        return keys.size();
+    }
+
+    /**
+     * @brief Retrieves the memory the perfect hash adds on top of the key and value arrays.
+     *
+     * @return std::size_t The number of bytes.
+     */
+    [[nodiscard]] std::size_t overhead_size() const {
+        return function.memory_size();
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename InputIt>
+PerfectHashDict<key_t, value_t, Hash, KeyEqual>::PerfectHashDict(InputIt begin, InputIt end, const Hash& hash, const KeyEqual& equal)
+        : function(hash, equal), key_equal(equal) {
+    std::vector<key_t> given_keys;
+    std::vector<value_t> given_values;
+    for (; begin != end; ++begin){
+        auto&& [key, value] = *begin;
+        given_keys.push_back(key);
+        given_values.push_back(value);
+    }
+    function.build(given_keys.size(), [&](std::size_t i) -> const key_t& { return given_keys[i]; });
+
+    // the pairs are moved to the indexes the function gives their keys
+    std::vector<std::size_t> order(given_keys.size());
+    for (std::size_t i = 0; i < given_keys.size(); i++) order[function.index_of(given_keys[i])] = i;
+    keys.reserve(order.size());
+    values.reserve(order.size());
+    for (std::size_t i : order){
+        keys.push_back(std::move(given_keys[i]));
+        values.push_back(std::move(given_values[i]));
+    }
+}
+
+#endif //LEARNING_PERFECTHASHDICT_H
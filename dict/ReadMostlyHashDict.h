@@ -0,0 +1,467 @@
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <iostream>
+#include <utility>
+
+#include "EpochManager.h"
+#include "HashPolicy.h"
+#include "Hashing.h"
+
+#ifndef LEARNING_READMOSTLYHASHDICT_H
+#define LEARNING_READMOSTLYHASHDICT_H
+
+
+/**
+ * @brief A chain node of ReadMostlyHashDict.
+ *
+ * The key and the value never change after the node is published. Assigning a new value
+ * publishes a new node instead.
+ *
+ * @tparam key_type The type of the key stored in the node.
+ * @tparam value_type The type of the value stored in the node.
+ */
+template<typename key_type, typename value_type>
+struct AtomicListEl {
+    std::size_t hash;                                           /**< The full hash of the key. */
+    key_type key;                                               /**< The key stored in the node. */
+    value_type value;                                           /**< The value associated with the key. */
+    std::atomic<AtomicListEl<key_type, value_type>*> next_pointer; /**< Pointer to the next node in the chain. */
+
+    template<typename K, typename V>
+    AtomicListEl(std::size_t node_hash, K&& node_key, V&& node_value, AtomicListEl<key_type, value_type>* next)
+            : hash(node_hash), key(std::forward<K>(node_key)), value(std::forward<V>(node_value)), next_pointer(next) {}
+};
+
+
+/**
+ * @brief The bucket array of ReadMostlyHashDict.
+ *
+ * @tparam key_type The type of the keys.
+ * @tparam value_type The type of the values.
+ */
+template<typename key_type, typename value_type>
+struct AtomicBucketArray {
+    int size;                                                        /**< The number of buckets, a power of two. */
+    std::atomic<AtomicListEl<key_type, value_type>*>* buckets;       /**< The heads of the chains. */
+
+    explicit AtomicBucketArray(int bucket_count) : size(bucket_count) {
+        buckets = new std::atomic<AtomicListEl<key_type, value_type>*>[size];
+        for (int i = 0; i < size; i++) buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Deletes the bucket heads and every node still linked in the chains.
+     */
+    ~AtomicBucketArray(){
+        for (int i = 0; i < size; i++){
+            AtomicListEl<key_type, value_type>* curr_el = buckets[i].load(std::memory_order_relaxed);
+            while (curr_el != nullptr){
+                AtomicListEl<key_type, value_type>* next = curr_el->next_pointer.load(std::memory_order_relaxed);
+                delete curr_el;
+                curr_el = next;
+            }
+        }
+        delete[] buckets;
+    }
+};
+
+
+/**
+ * @brief A separate-chaining dictionary whose readers never lock or wait.
+ *
+ * Meant for tables that are read all the time and changed rarely. Bucket heads and next
+ * pointers are atomic. A writer prepares a node completely and publishes it with a single
+ * release store, so a reader that follows the pointers with acquire loads always sees whole
+ * nodes. Writers are serialized by one mutex among themselves, but they never block readers.
+ *
+ * Popped and replaced nodes are not deleted right away. They go to an EpochManager, which
+ * deletes them once no reader can still be looking at them. Growing builds a new bucket
+ * array out of copies of the nodes and publishes it with one store. The old array and its
+ * nodes are retired as a whole, so a reader that is still walking them finds every key.
+ *
+ * Readers get copies (try_get, find) or a callback with a const reference (read), never a
+ * reference that could outlive the node.
+ *
+ * Every reading thread takes one of EPOCH_MAX_THREADS (256) slots of the EpochManager on its
+ * first read and gives it back when it exits. A read from a thread beyond that many running
+ * readers throws.
+ *
+ * @tparam key_t The type of keys stored in the ReadMostlyHashDict, must be copyable.
+ * @tparam value_t The type of values associated with the keys, must be copyable.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, std::equal_to<key_t> by default.
+ */
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
+class ReadMostlyHashDict {
+protected:
+    using node_type = AtomicListEl<key_t, value_t>;
+    using table_type = AtomicBucketArray<key_t, value_t>;
+
+    std::atomic<table_type*> table;       /**< The current bucket array. */
+    int element_count;                    /**< The number of key-value pairs, only touched by writers. */
+    std::atomic<int> published_count;     /**< element_count as seen by readers. */
+    std::mutex writer_lock;               /**< Serializes writers. */
+    mutable EpochManager epochs;          /**< Reclaims the nodes and bucket arrays that writers unlink. */
+
+    Hash hasher;                          /**< The hash functor. */
+    KeyEqual key_equal;                   /**< The key comparison functor. */
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes the dictionary with 8 empty buckets.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
+     */
+    explicit ReadMostlyHashDict(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Destructor.
+     *
+     * Must not run while other threads still use the dictionary.
+     */
+    ~ReadMostlyHashDict(){
+        delete table.load(std::memory_order_relaxed);
+    }
+
+    ReadMostlyHashDict(const ReadMostlyHashDict&) = delete;
+    ReadMostlyHashDict& operator=(const ReadMostlyHashDict&) = delete;
+
+    /**
+     * @brief Adds a key-value pair. Does nothing if the key is already present.
+     *
+     * @param key The key to be added.
+     * @param value The value associated with the key.
+     * @return true If the pair was inserted.
+     * @return false If the key was already present.
+     */
+    bool add(const key_t& key, const value_t& value);
+
+    /**
+     * @brief Inserts a key-value pair, or replaces the value if the key is already present.
+     *
+     * Readers see either the old or the new value, never a mix of both.
+     *
+     * @param key The key.
+     * @param value The value to insert or assign.
+     * @return true If the pair was inserted.
+     * @return false If an existing value was replaced.
+     */
+    bool insert_or_assign(const key_t& key, const value_t& value);
+
+    /**
+     * @brief Removes a key-value pair.
+     *
+     * @param key The key to be removed.
+     * @throws std::logic_error If the key is not found.
+     */
+    void pop(const key_t& key);
+
+    /**
+     * @brief Removes a key-value pair if the key is present.
+     *
+     * @param key The key to be removed.
+     * @return true If the key was found and removed.
+     * @return false If the key was not present.
+     */
+    bool erase(const key_t& key);
+
+    /**
+     * @brief Checks if a key exists. Never locks.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false Otherwise.
+     * @throws std::logic_error If EPOCH_MAX_THREADS other running threads already read from an EpochManager.
+     */
+    bool is_in(const key_t& key) const;
+
+    /**
+     * @brief Copies the value of a key into out. Never locks.
+     *
+     * @param key The key to look for.
+     * @param out Receives the value if the key is present.
+     * @return true If the key was found.
+     * @return false Otherwise, out is left unchanged.
+     * @throws std::logic_error If EPOCH_MAX_THREADS other running threads already read from an EpochManager.
+     */
+    bool find(const key_t& key, value_t& out) const;
+
+    /**
+     * @brief Retrieves a copy of the value associated with a key, if there is one. Never locks.
+     *
+     * @param key The key to look for.
+     * @return std::optional<value_t> The value, or std::nullopt if the key is not present.
+     * @throws std::logic_error If EPOCH_MAX_THREADS other running threads already read from an EpochManager.
+     */
+    std::optional<value_t> try_get(const key_t& key) const;
+
+    /**
+     * @brief Runs a function on the value of a key without copying it. Never locks.
+     *
+     * The reference is only valid inside the function.
+     *
+     * @param key The key to look for.
+     * @param function Called as function(const value_t&) if the key is present.
+     * @return true If the key was found.
+     * @return false Otherwise.
+     * @throws std::logic_error If EPOCH_MAX_THREADS other running threads already read from an EpochManager.
+     */
+    template<typename F>
+    bool read(const key_t& key, F&& function) const;
+
+    /**
+     * @brief Retrieves the number of key-value pairs.
+     *
+     * @return int The count of elements.
+     */
+    [[nodiscard]] int getSize() const {
+        return published_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retrieves the current number of buckets.
+     *
+     * @return int The number of buckets.
+     */
+    [[nodiscard]] int getTrueSize() const {
+        return table.load(std::memory_order_acquire)->size;
+    }
+
+    /**
+     * @brief Prints the contents of the ReadMostlyHashDict.
+     *
+     * @param out The output stream to print to. Defaults to std::cout.
+     */
+    void print(std::ostream& out = std::cout) const;
+
+
+protected:
+    /**
+     * @brief Finds the node of a key in a bucket array.
+     *
+     * Safe for readers as long as the caller is pinned, and for writers under writer_lock.
+     *
+     * @param current The bucket array to search.
+     * @param key The key to search for.
+     * @param hash The hash of the key.
+     * @param previous If not nullptr, set to the link that points to the found node.
+     * @return node_type* The node, or nullptr if the key is not present.
+     */
+    node_type* find_node(table_type* current, const key_t& key, std::size_t hash,
+                         std::atomic<node_type*>** previous = nullptr) const;
+
+    /**
+     * @brief Links a new node for a key that is known to be absent. writer_lock must be held.
+     *
+     * @param current The current bucket array.
+     * @param key The key.
+     * @param value The value.
+     * @param hash The hash of the key.
+     */
+    void add_locked(table_type* current, const key_t& key, const value_t& value, std::size_t hash);
+
+    /**
+     * @brief Doubles the bucket array if the load factor exceeds 0.75. writer_lock must be held.
+     */
+    void grow_if_needed();
+
+    /**
+     * @brief Deletes a retired node.
+     */
+    static void delete_node(void* node){
+        delete static_cast<node_type*>(node);
+    }
+
+    /**
+     * @brief Deletes a retired bucket array together with its nodes.
+     */
+    static void delete_table(void* old_table){
+        delete static_cast<table_type*>(old_table);
+    }
+
+    /**
+     * @brief Overloads the insertion operator to print the ReadMostlyHashDict.
+     *
+     * @param out The output stream.
+     * @param dict The ReadMostlyHashDict to print.
+     * @return std::ostream& The output stream.
+     */
+    friend std::ostream& operator <<(std::ostream& out, const ReadMostlyHashDict& dict){
+        dict.print(out);
+        return out;
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::ReadMostlyHashDict(const Hash& hash, const KeyEqual& equal)
+        : element_count(0), published_count(0), hasher(hash), key_equal(equal) {
+    table.store(new table_type(8), std::memory_order_release);
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::add(const key_t& key, const value_t& value){
+    std::lock_guard<std::mutex> guard(writer_lock);
+    std::size_t hash = hasher(key);
+    table_type* current = table.load(std::memory_order_relaxed);
+    if (find_node(current, key, hash) != nullptr) return false; // do nothing
+
+    add_locked(current, key, value, hash);
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::insert_or_assign(const key_t& key, const value_t& value){
+    std::lock_guard<std::mutex> guard(writer_lock);
+    std::size_t hash = hasher(key);
+    table_type* current = table.load(std::memory_order_relaxed);
+    std::atomic<node_type*>* previous = nullptr;
+    node_type* old_el = find_node(current, key, hash, &previous);
+    if (old_el == nullptr){
+        // still under the same lock, so no other writer can add the key in between
+        add_locked(current, key, value, hash);
+        return true;
+    }
+
+    // the replacement takes the place of the old node in one store
+    node_type* new_el = new node_type(hash, key, value, old_el->next_pointer.load(std::memory_order_relaxed));
+    previous->store(new_el, std::memory_order_release);
+    epochs.retire(old_el, &delete_node);
+    return false;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::pop(const key_t& key){
+    if (!erase(key)) throw std::logic_error("no such key in the dict!!!");
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::erase(const key_t& key){
+    std::lock_guard<std::mutex> guard(writer_lock);
+    std::size_t hash = hasher(key);
+    std::atomic<node_type*>* previous = nullptr;
+    node_type* element_to_delete = find_node(table.load(std::memory_order_relaxed), key, hash, &previous);
+    if (element_to_delete == nullptr) return false;
+
+    // readers standing on the node can still follow its next pointer, it is left untouched
+    previous->store(element_to_delete->next_pointer.load(std::memory_order_relaxed), std::memory_order_release);
+    epochs.retire(element_to_delete, &delete_node);
+
+    element_count--;
+    published_count.store(element_count, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::is_in(const key_t& key) const{
+    EpochManager::Guard pin = epochs.pin();
+    return find_node(table.load(std::memory_order_acquire), key, hasher(key)) != nullptr;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::find(const key_t& key, value_t& out) const{
+    EpochManager::Guard pin = epochs.pin();
+    node_type* element = find_node(table.load(std::memory_order_acquire), key, hasher(key));
+    if (element == nullptr) return false;
+    out = element->value;
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::optional<value_t> ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::try_get(const key_t& key) const{
+    EpochManager::Guard pin = epochs.pin();
+    node_type* element = find_node(table.load(std::memory_order_acquire), key, hasher(key));
+    if (element == nullptr) return std::nullopt;
+    return element->value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+template<typename F>
+bool ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::read(const key_t& key, F&& function) const{
+    EpochManager::Guard pin = epochs.pin();
+    node_type* element = find_node(table.load(std::memory_order_acquire), key, hasher(key));
+    if (element == nullptr) return false;
+    function(static_cast<const value_t&>(element->value));
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::print(std::ostream& out) const {
+    EpochManager::Guard pin = epochs.pin();
+    table_type* current = table.load(std::memory_order_acquire);
+    for (int i = 0; i < current->size; i++){
+        node_type* curr_el = current->buckets[i].load(std::memory_order_acquire);
+        while (curr_el != nullptr){
+            out << curr_el->key << ':' << curr_el->value << ' ';
+            curr_el = curr_el->next_pointer.load(std::memory_order_acquire);
+        }
+    }
+}
+
+
+//protected:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+typename ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::node_type*
+ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::find_node(table_type* current, const key_t& key, std::size_t hash,
+                                                              std::atomic<node_type*>** previous) const{
+    std::atomic<node_type*>* link = &current->buckets[map_to_bucket(hash, current->size, SizingMode::POWER_OF_TWO)];
+    node_type* curr_el = link->load(std::memory_order_acquire);
+    while (curr_el != nullptr){
+        if (curr_el->hash == hash && key_equal(curr_el->key, key)){
+            if (previous != nullptr) *previous = link;
+            return curr_el;
+        }
+        link = &curr_el->next_pointer;
+        curr_el = link->load(std::memory_order_acquire);
+    }
+    return nullptr;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::add_locked(table_type* current, const key_t& key,
+                                                                    const value_t& value, std::size_t hash){
+    std::atomic<node_type*>& head = current->buckets[map_to_bucket(hash, current->size, SizingMode::POWER_OF_TWO)];
+    // the node is complete before the release store makes it reachable
+    node_type* new_el = new node_type(hash, key, value, head.load(std::memory_order_relaxed));
+    head.store(new_el, std::memory_order_release);
+
+    element_count++;
+    published_count.store(element_count, std::memory_order_relaxed);
+    grow_if_needed();
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void ReadMostlyHashDict<key_t, value_t, Hash, KeyEqual>::grow_if_needed(){
+    table_type* current = table.load(std::memory_order_relaxed);
+    if ((long long)element_count * 4 <= (long long)current->size * 3) return;
+
+    // readers may still walk the old chains, so the new array gets copies of the nodes
+    table_type* bigger = new table_type(current->size * 2);
+    for (int i = 0; i < current->size; i++){
+        node_type* curr_el = current->buckets[i].load(std::memory_order_relaxed);
+        while (curr_el != nullptr){
+            std::atomic<node_type*>& head = bigger->buckets[map_to_bucket(curr_el->hash, bigger->size, SizingMode::POWER_OF_TWO)];
+            head.store(new node_type(curr_el->hash, curr_el->key, curr_el->value, head.load(std::memory_order_relaxed)),
+                       std::memory_order_relaxed);
+            curr_el = curr_el->next_pointer.load(std::memory_order_relaxed);
+        }
+    }
+
+    table.store(bigger, std::memory_order_release);
+    epochs.retire(current, &delete_table);
+    // the old array holds a copy of every node, too big to wait for the next batch of retires
+    epochs.reclaim();
+}
+
+#endif //LEARNING_READMOSTLYHASHDICT_H
@@ -0,0 +1,443 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <optional>
+
+#include "Hashing.h"
+
+#ifndef LEARNING_ROBINHOODDICT_H
+#define LEARNING_ROBINHOODDICT_H
+
+
+/**
+ * @brief A structure representing one slot of the RobinHoodDict table.
+ *
+ * Keys and values are stored inline, so the whole table is a single contiguous array.
+ *
+ * @tparam key_type The type of the key stored in the slot.
+ * @tparam value_type The type of the value stored in the slot.
+ */
+template<typename key_type, typename value_type>
+struct RobinHoodSlot{
+    unsigned distance;     /**< Probe distance from the home slot plus one, 0 means the slot is empty. */
+    key_type key;          /**< The key stored in the slot. */
+    value_type value;      /**< The value associated with the key. */
+};
+
+
+/**
+ * @brief A templated RobinHoodDict class implementing a hash table using open addressing.
+ *
+ * This is a sibling of HashDict with the same add/pop/is_in/operator[] API. Instead of
+ * chaining heap-allocated nodes, all entries live in one flat array of slots. Collisions
+ * are resolved with Robin Hood linear probing (an entry that is further from its home slot
+ * takes the place of a closer one) and removal uses backward-shift deletion, so no
+ * tombstones are ever left behind.
+ *
+ * The capacity is always a power of two and the table grows when occupancy exceeds 87.5%.
+ *
+ * @tparam key_t The type of keys stored in the RobinHoodDict.
+ * @tparam value_t The type of values associated with the keys.
+ * @tparam Hash The hash functor, DefaultHash<key_t> by default.
+ * @tparam KeyEqual The key comparison functor, std::equal_to<key_t> by default.
+ */
+template<typename key_t, typename value_t, typename Hash = DefaultHash<key_t>, typename KeyEqual = std::equal_to<key_t>>
+class RobinHoodDict {
+protected:
+    int real_size;                                /**< The current capacity of the table (a power of two). */
+    int element_count;                            /**< The number of key-value pairs currently in the dictionary. */
+    int shift;                                    /**< 64 - log2(real_size), used to map a hash to a slot. */
+
+    RobinHoodSlot<key_t, value_t>* slots;         /**< Flat array of slots. */
+
+    Hash hasher;                                  /**< The hash functor. */
+    KeyEqual key_equal;                           /**< The key comparison functor. */
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes the dictionary with a default capacity of 8 empty slots.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The key comparison functor to use.
+     */
+    explicit RobinHoodDict(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Destructor.
+     *
+     * Cleans up the allocated memory for the table.
+     */
+    ~RobinHoodDict(){
+        delete[] slots;
+    }
+
+    RobinHoodDict(const RobinHoodDict&) = delete;
+    RobinHoodDict& operator=(const RobinHoodDict&) = delete;
+
+    /**
+     * @brief Adds a key-value pair to the RobinHoodDict.
+     *
+     * Does nothing if the key is already present. If the occupancy would exceed 87.5%,
+     * the table is doubled first.
+     *
+     * @param key The key to be added.
+     * @param value The value associated with the key.
+     */
+    void add(key_t key, value_t value);
+
+    /**
+     * @brief Removes a key-value pair from the RobinHoodDict.
+     *
+     * The following entries of the probe run are shifted one slot back.
+     *
+     * @param key The key to be removed.
+     * @throws std::logic_error If the key is not found.
+     */
+    void pop(key_t key);
+
+    /**
+     * @brief Checks if a key exists in the RobinHoodDict.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false Otherwise.
+     */
+    bool is_in(key_t key) const;
+
+    /**
+     * @brief Finds the value associated with a key.
+     *
+     * @param key The key to look for.
+     * @return value_t* Pointer to the value, or nullptr if the key is not present.
+     */
+    value_t* find(const key_t& key);
+
+    /**
+     * @brief Finds the value associated with a key (const version).
+     *
+     * @param key The key to look for.
+     * @return const value_t* Pointer to the value, or nullptr if the key is not present.
+     */
+    const value_t* find(const key_t& key) const;
+
+    /**
+     * @brief Retrieves a copy of the value associated with a key, if there is one.
+     *
+     * @param key The key to look for.
+     * @return std::optional<value_t> The value, or std::nullopt if the key is not present.
+     */
+    std::optional<value_t> try_get(const key_t& key) const;
+
+    /**
+     * @brief Removes a key-value pair if the key is present.
+     *
+     * The non-throwing counterpart of pop().
+     *
+     * @param key The key to be removed.
+     * @return true If the key was found and removed.
+     * @return false If the key was not present.
+     */
+    bool erase(const key_t& key);
+
+    /**
+     * @brief Retrieves the number of key-value pairs in the RobinHoodDict.
+     *
+     * @return int The count of elements.
+     */
+    [[nodiscard]] int getSize() const {
+        return element_count;
+    }
+
+    /**
+     * @brief Retrieves the current capacity of the table.
+     *
+     * @return int The number of slots.
+     */
+    [[nodiscard]] int getTrueSize() const {
+        return real_size;
+    }
+
+
+    // operators
+
+
+    /**
+     * @brief Overloads the subscript operator to access values by key.
+     *
+     * @param key The key whose associated value is to be accessed.
+     * @return value_t& Reference to the value associated with the key.
+     * @throws std::logic_error If the key is not found.
+     */
+    value_t& operator[](key_t key);
+
+    /**
+     * @brief Overloads the subscript operator to access values by key (const version).
+     *
+     * @param key The key whose associated value is to be accessed.
+     * @return const value_t& Const reference to the value associated with the key.
+     * @throws std::logic_error If the key is not found.
+     */
+    const value_t& operator[](key_t key) const;
+
+    /**
+     * @brief Prints the contents of the RobinHoodDict.
+     *
+     * @param out The output stream to print to. Defaults to std::cout.
+     */
+    void print(std::ostream& out = std::cout) const;
+
+
+protected:
+
+    /**
+     * @brief Finds the slot holding the given key.
+     *
+     * Probing stops as soon as a slot closer to its home than the probe itself is met,
+     * which is what makes misses cheap in a Robin Hood table.
+     *
+     * @param key The key to search for.
+     * @return int The slot index, or -1 if the key is not present.
+     */
+    int find_index(const key_t& key) const;
+
+    /**
+     * @brief Places a key-value pair that is known to be absent into the table.
+     *
+     * @param key The key to place.
+     * @param value The value to place.
+     */
+    void insert_absent(key_t&& key, value_t&& value){
+        place(home_slot(getHash(key)), 1, std::move(key), std::move(value));
+    }
+
+    /**
+     * @brief Puts an absent key-value pair into a slot of its probe run, pushing the rest of the run on.
+     *
+     * @param position The slot to start at, where the probe for the key stopped.
+     * @param distance The probe distance of the key at that slot.
+     * @param key The key to place.
+     * @param value The value to place.
+     */
+    void place(int position, unsigned distance, key_t&& key, value_t&& value);
+
+    /**
+     * @brief Maps a hash to its home slot.
+     *
+     * Uses Fibonacci hashing: the hash is multiplied by 2^64 / phi and the top bits are taken.
+     *
+     * @param hash The hash of the key.
+     * @return int The home slot index.
+     */
+    int home_slot(std::size_t hash) const {
+        return static_cast<int>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    /**
+     * @brief Doubles the capacity of the table and reinserts all entries.
+     */
+    void grow();
+
+    /**
+     * @brief Computes the hash of a key with the Hash functor.
+     *
+     * @param key The key to hash.
+     * @return std::size_t The computed hash.
+     */
+    std::size_t getHash(const key_t& key) const {
+        return hasher(key);
+    }
+
+    /**
+     * @brief Overloads the insertion operator to print the RobinHoodDict.
+     *
+     * @param out The output stream.
+     * @param dict The RobinHoodDict to print.
+     * @return std::ostream& The output stream.
+     */
+    friend std::ostream& operator <<(std::ostream& out, const RobinHoodDict& dict){
+        dict.print(out);
+        return out;
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+RobinHoodDict<key_t, value_t, Hash, KeyEqual>::RobinHoodDict(const Hash& hash, const KeyEqual& equal) : hasher(hash), key_equal(equal) {
+    real_size = 8;
+    shift = 64 - 3;
+    element_count = 0;
+    slots = new RobinHoodSlot<key_t, value_t>[real_size];
+    for (int i = 0; i < real_size; i++) slots[i].distance = 0;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void RobinHoodDict<key_t, value_t, Hash, KeyEqual>::add(key_t key, value_t value){
+    std::size_t hash = getHash(key);
+    int mask = real_size - 1;
+    int position = home_slot(hash);
+    unsigned distance = 1;
+
+    // one probe: the slot where the lookup for the key fails is the slot it is inserted into
+    while (slots[position].distance >= distance){
+        if (slots[position].distance == distance && key_equal(slots[position].key, key))
+            return; // do nothing, same as HashDict
+        position = (position + 1) & mask;
+        distance++;
+    }
+
+    // keeping probe runs short by enlarging the table
+    if ((long long)(element_count + 1) * 8 > (long long)real_size * 7){
+        grow();
+        position = home_slot(hash);
+        distance = 1;
+    }
+
+    place(position, distance, std::move(key), std::move(value));
+    element_count++;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void RobinHoodDict<key_t, value_t, Hash, KeyEqual>::pop(key_t key){
+    if (!erase(key)) throw std::logic_error("no such key in the dict!!!");
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool RobinHoodDict<key_t, value_t, Hash, KeyEqual>::erase(const key_t& key){
+    int position = find_index(key);
+    if (position == -1) return false;
+
+    int mask = real_size - 1;
+    int next = (position + 1) & mask;
+    // backward shift: pull every displaced follower one slot closer to its home
+    while (slots[next].distance > 1){
+        slots[position].key = std::move(slots[next].key);
+        slots[position].value = std::move(slots[next].value);
+        slots[position].distance = slots[next].distance - 1;
+        position = next;
+        next = (next + 1) & mask;
+    }
+    slots[position].distance = 0;
+    slots[position].key = key_t();
+    slots[position].value = value_t();
+
+    element_count--;
+    return true;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+bool RobinHoodDict<key_t, value_t, Hash, KeyEqual>::is_in(key_t key) const{
+    return find_index(key) != -1;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+value_t* RobinHoodDict<key_t, value_t, Hash, KeyEqual>::find(const key_t& key){
+    int position = find_index(key);
+    return position == -1 ? nullptr : &slots[position].value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+const value_t* RobinHoodDict<key_t, value_t, Hash, KeyEqual>::find(const key_t& key) const{
+    int position = find_index(key);
+    return position == -1 ? nullptr : &slots[position].value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+std::optional<value_t> RobinHoodDict<key_t, value_t, Hash, KeyEqual>::try_get(const key_t& key) const{
+    const value_t* value = find(key);
+    if (value == nullptr) return std::nullopt;
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+value_t& RobinHoodDict<key_t, value_t, Hash, KeyEqual>::operator[](key_t key) {
+    value_t* value = find(key);
+    if (value == nullptr) throw std::logic_error("no such key in the dict!!!");
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+const value_t& RobinHoodDict<key_t, value_t, Hash, KeyEqual>::operator[](key_t key) const{
+    const value_t* value = find(key);
+    if (value == nullptr) throw std::logic_error("no such key in the dict!!!");
+    return *value;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void RobinHoodDict<key_t, value_t, Hash, KeyEqual>::print(std::ostream& out) const {
+    for (int i = 0; i < real_size; i++){
+        if (slots[i].distance == 0) continue;
+        out << slots[i].key << ':' << slots[i].value << ' ';
+    }
+}
+
+
+//protected:
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+int RobinHoodDict<key_t, value_t, Hash, KeyEqual>::find_index(const key_t& key) const {
+    int mask = real_size - 1;
+    int position = home_slot(getHash(key));
+    unsigned distance = 1;
+
+    // an entry closer to its home than we are means the key would have been placed before it
+    while (slots[position].distance >= distance){
+        if (slots[position].distance == distance && key_equal(slots[position].key, key)) return position;
+        position = (position + 1) & mask;
+        distance++;
+    }
+    return -1;
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void RobinHoodDict<key_t, value_t, Hash, KeyEqual>::place(int position, unsigned distance, key_t&& key, value_t&& value){
+    int mask = real_size - 1;
+    while (true){
+        RobinHoodSlot<key_t, value_t>& slot = slots[position];
+        if (slot.distance == 0){
+            slot.key = std::move(key);
+            slot.value = std::move(value);
+            slot.distance = distance;
+            return;
+        }
+        // take from the rich: the resident is closer to home, so it moves on instead
+        if (slot.distance < distance){
+            std::swap(slot.key, key);
+            std::swap(slot.value, value);
+            std::swap(slot.distance, distance);
+        }
+        position = (position + 1) & mask;
+        distance++;
+    }
+}
+
+template<typename key_t, typename value_t, typename Hash, typename KeyEqual>
+void RobinHoodDict<key_t, value_t, Hash, KeyEqual>::grow(){
+    RobinHoodSlot<key_t, value_t>* old_slots = slots;
+    int old_size = real_size;
+
+    // allocating first, so a bad_alloc leaves the dict as it was
+    RobinHoodSlot<key_t, value_t>* new_slots = new RobinHoodSlot<key_t, value_t>[2 * old_size];
+    for (int i = 0; i < 2 * old_size; i++) new_slots[i].distance = 0;
+    slots = new_slots;
+    real_size = 2 * old_size;
+    shift--;
+
+    for (int i = 0; i < old_size; i++){
+        if (old_slots[i].distance == 0) continue;
+        insert_absent(std::move(old_slots[i].key), std::move(old_slots[i].value));
+    }
+
+    delete[] old_slots;
+}
+
+
+#endif //LEARNING_ROBINHOODDICT_H
@@ -0,0 +1,238 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "Hashing.h"
+
+#ifndef LEARNING_STATICHASHDICT_H
+#define LEARNING_STATICHASHDICT_H
+
+
+/**
+ * @brief A dictionary from strings to values, laid out entirely at compile time.
+ *
+ * Meant for keyword and opcode tables that never change. The constructor is constexpr: it
+ * picks the seed and a perfect placement of the keys (one 16-bit pilot per bucket of about two
+ * keys, as in PerfectHash) while compiling, and the finished table is a constant in the binary.
+ * There is no allocation and no startup work, and a lookup is a hash, one pilot read and one
+ * key comparison, with no probing. A lookup with a constant key is folded by the compiler.
+ *
+ * Example:
+ * @code
+ * constexpr auto opcodes = make_static_dict<int>({{"add", 1}, {"sub", 2}, {"mul", 3}});
+ * static_assert(opcodes["sub"] == 2);
+ * const int* code = opcodes.find(token);   // token read at run time
+ * @endcode
+ *
+ * A repeated key is a compile error.
+ *
+ * @tparam value_t The type of values, a literal type that is default constructible.
+ * @tparam N The number of keys.
+ */
+template<typename value_t, std::size_t N>
+class StaticHashDict {
+    static_assert(N > 0, "a StaticHashDict needs at least one key");
+
+protected:
+    /**
+     * @brief The number of slots: the smallest power of two holding twice the keys.
+     */
+    static constexpr std::size_t slot_count(){
+        std::size_t slots = 1;
+        while (slots < 2 * N) slots *= 2;
+        return slots;
+    }
+
+    static constexpr std::size_t BUCKETS = N / 2 + 1;          /**< The number of buckets, one pilot each. */
+    static constexpr std::size_t SLOTS = slot_count();         /**< The number of slots. */
+    static constexpr int MAX_SEEDS = 64;                       /**< Seeds tried before the build gives up. */
+
+    uint64_t seed = 0;                   /**< The seed of the key hashes, chosen by the constructor. */
+    uint16_t pilots[BUCKETS] = {};       /**< The pilot of every bucket. */
+    std::string_view keys[SLOTS] = {};   /**< The key in every slot. */
+    value_t values[SLOTS] = {};          /**< The value in every slot. */
+    bool used[SLOTS] = {};               /**< Whether a slot holds a key. */
+
+public:
+    /**
+     * @brief Builds the dictionary, at compile time when the result is constexpr.
+     *
+     * @param items The key-value pairs.
+     * @throws std::logic_error If a key repeats, which stops the compilation of a constexpr dictionary.
+     */
+    constexpr explicit StaticHashDict(const std::pair<std::string_view, value_t> (&items)[N]);
+
+    /**
+     * @brief Looks up the value of a key.
+     *
+     * @param key The key to look for.
+     * @return const value_t* Pointer to the value, or nullptr if the key is absent.
+     */
+    constexpr const value_t* find(std::string_view key) const {
+        uint64_t hash = key_hash(key, seed);
+        std::size_t slot = slot_of(hash, pilots[bucket_of(hash)]);
+        return used[slot] && keys[slot] == key ? &values[slot] : nullptr;
+    }
+
+    /**
+     * @brief Retrieves the value of a key.
+     *
+     * @param key The key to look for.
+     * @return const value_t& The value.
+     * @throws std::logic_error If the key is absent.
+     */
+    constexpr const value_t& operator[](std::string_view key) const {
+        const value_t* value = find(key);
+        if (value == nullptr) throw std::logic_error("no such key in the dict!!!");
+        return *value;
+    }
+
+    /**
+     * @brief Checks if a key is in the StaticHashDict.
+     *
+     * @param key The key to check for.
+     * @return true If the key is present.
+     * @return false If it is not.
+     */
+    constexpr bool is_in(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief Retrieves the number of key-value pairs.
+     *
+     * @return std::size_t N.
+     */
+    [[nodiscard]] static constexpr std::size_t getSize(){
+        return N;
+    }
+
+    /**
+     * @brief Retrieves the number of slots.
+     *
+     * @return std::size_t The slot count.
+     */
+    [[nodiscard]] static constexpr std::size_t getTrueSize(){
+        return SLOTS;
+    }
+
+
+protected:
+    /**
+     * @brief FNV-1a over the bytes of the key, finished with mix64. Unlike hash_bytes it is constexpr.
+     */
+    static constexpr uint64_t key_hash(std::string_view key, uint64_t hash_seed){
+        uint64_t hash = 0xCBF29CE484222325ULL ^ hash_seed;
+        for (char c : key){
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001B3ULL;
+        }
+        return mix64(hash);
+    }
+
+    static constexpr std::size_t bucket_of(uint64_t hash){
+        return static_cast<std::size_t>(((hash >> 32) * BUCKETS) >> 32);
+    }
+
+    static constexpr std::size_t slot_of(uint64_t hash, uint16_t pilot){
+        return static_cast<std::size_t>(mix64(hash ^ mix64(pilot + 1))) & (SLOTS - 1);
+    }
+
+    /**
+     * @brief One placement attempt with the current seed, fills the slots and the pilots.
+     *
+     * @return false If some bucket has no free pilot or two different keys share a hash.
+     */
+    constexpr bool try_build(const std::pair<std::string_view, value_t> (&items)[N]);
+}; // End of the class
+
+
+
+/**
+ * @brief Builds a StaticHashDict, counting the keys for you.
+ *
+ * @tparam value_t The type of values, given explicitly.
+ * @param items The key-value pairs, usually a braced list.
+ * @return StaticHashDict<value_t, N> The dictionary.
+ */
+template<typename value_t, std::size_t N>
+constexpr StaticHashDict<value_t, N> make_static_dict(const std::pair<std::string_view, value_t> (&items)[N]){
+    return StaticHashDict<value_t, N>(items);
+}
+
+
+
+// methods implementation
+
+//public:
+
+template<typename value_t, std::size_t N>
+constexpr StaticHashDict<value_t, N>::StaticHashDict(const std::pair<std::string_view, value_t> (&items)[N]){
+    for (std::size_t i = 0; i < N; i++){
+        for (std::size_t j = 0; j < i; j++){
+            if (items[i].first == items[j].first) throw std::logic_error("the key is already here!!!");
+        }
+    }
+
+    for (int attempt = 0; attempt < MAX_SEEDS; attempt++){
+        seed = mix64(0x9E3779B97F4A7C15ULL * (attempt + 1));
+        if (try_build(items)) return;
+    }
+    throw std::logic_error("can't lay out the static dict!!!");
+}
+
+
+//protected:
+
+template<typename value_t, std::size_t N>
+constexpr bool StaticHashDict<value_t, N>::try_build(const std::pair<std::string_view, value_t> (&items)[N]){
+    for (std::size_t s = 0; s < SLOTS; s++) used[s] = false;
+
+    uint64_t hashes[N] = {};
+    std::size_t sizes[BUCKETS] = {};
+    for (std::size_t i = 0; i < N; i++){
+        hashes[i] = key_hash(items[i].first, seed);
+        sizes[bucket_of(hashes[i])]++;
+    }
+
+    // the buckets, largest first, by insertion sort since N is small
+    std::size_t order[BUCKETS] = {};
+    for (std::size_t b = 0; b < BUCKETS; b++){
+        std::size_t j = b;
+        for (; j > 0 && sizes[order[j - 1]] < sizes[b]; j--) order[j] = order[j - 1];
+        order[j] = b;
+    }
+
+    std::size_t members[N] = {};
+    std::size_t slots[N] = {};
+    for (std::size_t bucket : order){
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < N; i++){
+            if (bucket_of(hashes[i]) == bucket) members[count++] = i;
+        }
+        if (count == 0) break; // the rest are empty
+
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot <= UINT16_MAX && !placed; pilot++){
+            placed = true;
+            for (std::size_t k = 0; k < count && placed; k++){
+                slots[k] = slot_of(hashes[members[k]], static_cast<uint16_t>(pilot));
+                placed = !used[slots[k]];
+                for (std::size_t m = 0; m < k && placed; m++) placed = slots[m] != slots[k];
+            }
+            if (placed) pilots[bucket] = static_cast<uint16_t>(pilot);
+        }
+        if (!placed) return false;
+
+        for (std::size_t k = 0; k < count; k++){
+            used[slots[k]] = true;
+            keys[slots[k]] = items[members[k]].first;
+            values[slots[k]] = items[members[k]].second;
+        }
+    }
+    return true;
+}
+
+#endif //LEARNING_STATICHASHDICT_H
@@ -0,0 +1,78 @@
+// Throughput of ConcurrentHashDict against a HashDict behind one global mutex.
+// Every thread runs a mix of 90% lookups, 5% inserts and 5% pops on random keys.
+//
+// build: g++ -std=c++17 -O2 concurrent_dict_bench.cpp -o concurrent_dict_bench -lpthread
+// run:   ./concurrent_dict_bench [max_threads] [operations_per_thread]
+//
+#include "../ConcurrentHashDict.h"
+#include "../HashDict.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int KEY_RANGE = 1 << 20;
+
+// xorshift, so that the random numbers themselves cost nothing
+struct Random {
+    uint64_t state;
+    explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+template<typename Operation>
+double run(int thread_count, int operations, Operation operation) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([t, operations, &operation]() {
+            Random random(t + 1);
+            for (int i = 0; i < operations; ++i) {
+                uint64_t r = random.next();
+                operation(static_cast<int>(r % KEY_RANGE), static_cast<int>((r >> 32) % 20)); // 5% adds, 5% pops
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return thread_count * (double)operations / seconds.count() / 1e6;
+}
+
+int main(int argc, char** argv) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+    int operations = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    if (max_threads < 1) max_threads = 1;
+
+    std::cout << "threads  global_mutex(Mops/s)  concurrent(Mops/s)\n";
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        HashDict<int, int> plain;
+        std::mutex global;
+        ConcurrentHashDict<int, int> striped(256);
+        for (int key = 0; key < KEY_RANGE; key += 2) {
+            plain.add(key, key);
+            striped.add(key, key);
+        }
+
+        double locked = run(threads, operations, [&](int key, int kind) {
+            std::lock_guard<std::mutex> guard(global);
+            if (kind == 0) plain.add(key, key);
+            else if (kind == 1) plain.erase(key);
+            else (void)static_cast<const HashDict<int, int>&>(plain).find(key);
+        });
+        double concurrent = run(threads, operations, [&](int key, int kind) {
+            if (kind == 0) striped.add(key, key);
+            else if (kind == 1) striped.erase(key);
+            else (void)striped.is_in(key);
+        });
+        std::cout << threads << "        " << locked << "              " << concurrent << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../Hashing.h"
+
+#ifndef LEARNING_CUCKOOFILTER_H
+#define LEARNING_CUCKOOFILTER_H
+
+
+/**
+ * @brief An approximate set with deletion: a cuckoo filter (Fan, Andersen, Kaminsky, Mitzenmacher).
+ *
+ * Only a short fingerprint of every element is kept, in buckets of 4 slots. An element may live
+ * in two buckets, i1 and i1 ^ hash(fingerprint), so a full bucket is resolved by kicking a
+ * fingerprint to its other bucket, and the other bucket can be found from the fingerprint alone.
+ * is_in never reports a false negative and reports a false positive with a probability of about
+ * 8 / 2^bits, where bits is the width of fingerprint_t:
+ * - uint8_t: about 3% false positives, 1 byte per slot;
+ * - uint16_t: about 0.012% false positives, 2 bytes per slot.
+ *
+ * A whole bucket is one 32-bit or 64-bit word, and it is compared against a fingerprint in one
+ * go with a SIMD-within-a-register zero-lane test, with no loop over the slots.
+ *
+ * Unlike a HashSet, adding the same element twice stores two copies, and each pop() removes one.
+ * Only pop elements that were added, or an unrelated element with the same fingerprint may vanish.
+ *
+ * @tparam var_type The type of elements.
+ * @tparam fingerprint_t uint8_t or uint16_t, the width of the fingerprints.
+ * @tparam Hash The hash functor, DefaultHash<var_type> by default.
+ */
+template<typename var_type, typename fingerprint_t = uint16_t, typename Hash = DefaultHash<var_type>>
+class CuckooFilter {
+    static_assert(std::is_same<fingerprint_t, uint8_t>::value || std::is_same<fingerprint_t, uint16_t>::value,
+                  "fingerprint_t must be uint8_t or uint16_t");
+
+protected:
+    /**
+     * @brief One bucket: 4 fingerprints packed into one word, 0 marks an empty slot.
+     */
+    using bucket_t = typename std::conditional<sizeof(fingerprint_t) == 1, uint32_t, uint64_t>::type;
+
+    static const int SLOTS = 4;                                      /**< Fingerprints per bucket. */
+    static const int BITS = 8 * sizeof(fingerprint_t);               /**< Bits per fingerprint. */
+    static const int MAX_KICKS = 500;                                /**< Relocations tried before the filter counts as full. */
+    static const bucket_t LOW_BITS = static_cast<bucket_t>(~bucket_t(0) / ((bucket_t(1) << BITS) - 1));   /**< 1 in every slot. */
+    static const bucket_t HIGH_BITS = static_cast<bucket_t>(LOW_BITS << (BITS - 1));                       /**< The top bit of every slot. */
+
+    bucket_t* buckets;              /**< The buckets. */
+    std::size_t bucket_count;       /**< The number of buckets, a power of two. */
+    std::size_t element_count;      /**< The number of stored fingerprints, the victim included. */
+
+    bool has_victim;                /**< Whether a fingerprint was left over by a failed add. */
+    std::size_t victim_index;       /**< A bucket of the left-over fingerprint. */
+    fingerprint_t victim;           /**< The left-over fingerprint. */
+
+    uint64_t random_state;          /**< State of the generator that picks the slot to kick. */
+    Hash hasher;                    /**< The hash functor. */
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * The filter holds about 95% of its slots before add() starts to fail, and the slot count is
+     * rounded up to a power of two, so the real capacity is between capacity and 2 * capacity.
+     *
+     * @param capacity The number of elements the filter must hold.
+     * @param hash The hash functor to use.
+     */
+    explicit CuckooFilter(std::size_t capacity, const Hash& hash = Hash());
+
+    /**
+     * @brief Destructor.
+     */
+    ~CuckooFilter(){
+        delete[] buckets;
+    }
+
+    CuckooFilter(const CuckooFilter&) = delete;
+    CuckooFilter& operator=(const CuckooFilter&) = delete;
+
+    /**
+     * @brief Adds an element to the CuckooFilter.
+     *
+     * @param var The element to be added.
+     * @return true If the element was stored.
+     * @return false If the filter is full and nothing more can be added. The add() that fills the
+     *               filter still stores its element; any later add() stores nothing until a pop()
+     *               makes room.
+     */
+    bool add(const var_type& var);
+
+    /**
+     * @brief Checks if an element may be in the CuckooFilter.
+     *
+     * @param var The element to check for.
+     * @return true If the element is probably present.
+     * @return false If it is surely absent.
+     */
+    bool is_in(const var_type& var) const;
+
+    /**
+     * @brief Removes one copy of an element from the CuckooFilter.
+     *
+     * @param var The element to be removed.
+     * @throws std::logic_error If the element is not found.
+     */
+    void pop(const var_type& var);
+
+    /**
+     * @brief Removes one copy of an element if its fingerprint is present.
+     *
+     * @param var The element to be removed.
+     * @return true If a fingerprint was removed.
+     * @return false If none was found.
+     */
+    bool erase(const var_type& var);
+
+    /**
+     * @brief Retrieves the number of elements in the CuckooFilter.
+     *
+     * @return std::size_t The count of stored fingerprints.
+     */
+    [[nodiscard]] std::size_t getSize() const {
+        return element_count;
+    }
+
+    /**
+     * @brief Retrieves the number of fingerprint slots.
+     *
+     * @return std::size_t The number of slots.
+     */
+    [[nodiscard]] std::size_t getTrueSize() const {
+        return bucket_count * SLOTS;
+    }
+
+    /**
+     * @brief Retrieves the memory used by the buckets.
+     *
+     * @return std::size_t The number of bytes.
+     */
+    [[nodiscard]] std::size_t memory_size() const {
+        return bucket_count * sizeof(bucket_t);
+    }
+
+    /**
+     * @brief The expected false positive rate of this fingerprint width when the filter is full.
+     *
+     * @return double The probability that is_in() is true for an absent element.
+     */
+    static double false_positive_rate(){
+        return 2.0 * SLOTS / static_cast<double>((1ULL << BITS) - 1);
+    }
+
+
+protected:
+    /**
+     * @brief Splits an element into its fingerprint and its first bucket.
+     *
+     * The bucket comes from the low bits of the mixed hash and the fingerprint from the high
+     * bits, so the two are independent. A zero fingerprint would look like an empty slot and is
+     * replaced by 1.
+     */
+    void locate(const var_type& var, fingerprint_t& fingerprint, std::size_t& index) const {
+        uint64_t hash = mix64(static_cast<uint64_t>(hasher(var)));
+        fingerprint = static_cast<fingerprint_t>(hash >> (64 - BITS));
+        if (fingerprint == 0) fingerprint = 1;
+        index = static_cast<std::size_t>(hash) & (bucket_count - 1);
+    }
+
+    /**
+     * @brief The other bucket of a fingerprint. Applying it twice gives back the first bucket.
+     */
+    std::size_t alternate(std::size_t index, fingerprint_t fingerprint) const {
+        return (index ^ static_cast<std::size_t>(mix64(fingerprint))) & (bucket_count - 1);
+    }
+
+    /**
+     * @brief Checks all 4 slots of a bucket for a fingerprint at once.
+     *
+     * XOR zeroes the matching slots, and the classic has-zero-byte trick finds a zero slot.
+     */
+    static bool bucket_has(bucket_t bucket, fingerprint_t fingerprint){
+        bucket_t x = bucket ^ static_cast<bucket_t>(LOW_BITS * fingerprint);
+        return ((x - LOW_BITS) & ~x & HIGH_BITS) != 0;
+    }
+
+    static fingerprint_t slot_of(bucket_t bucket, int slot){
+        return static_cast<fingerprint_t>(bucket >> (slot * BITS));
+    }
+
+    static void set_slot(bucket_t& bucket, int slot, fingerprint_t fingerprint){
+        bucket_t mask = static_cast<bucket_t>(static_cast<fingerprint_t>(~fingerprint_t(0))) << (slot * BITS);
+        bucket = (bucket & ~mask) | (static_cast<bucket_t>(fingerprint) << (slot * BITS));
+    }
+
+    /**
+     * @brief Stores a fingerprint in a free slot of a bucket.
+     *
+     * @return true If the bucket had a free slot.
+     */
+    bool put(std::size_t index, fingerprint_t fingerprint){
+        if (!bucket_has(buckets[index], 0)) return false;
+        for (int slot = 0; slot < SLOTS; slot++){
+            if (slot_of(buckets[index], slot) == 0){
+                set_slot(buckets[index], slot, fingerprint);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Clears one slot of a bucket holding a fingerprint.
+     *
+     * @return true If the fingerprint was found.
+     */
+    bool remove_from(std::size_t index, fingerprint_t fingerprint){
+        if (!bucket_has(buckets[index], fingerprint)) return false;
+        for (int slot = 0; slot < SLOTS; slot++){
+            if (slot_of(buckets[index], slot) == fingerprint){
+                set_slot(buckets[index], slot, 0);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief xorshift64, picks the slot to kick out.
+     */
+    uint64_t next_random(){
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        return random_state;
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename var_type, typename fingerprint_t, typename Hash>
+CuckooFilter<var_type, fingerprint_t, Hash>::CuckooFilter(std::size_t capacity, const Hash& hash)
+        : element_count(0), has_victim(false), victim_index(0), victim(0), random_state(0x9E3779B97F4A7C15ULL), hasher(hash) {
+    std::size_t needed = static_cast<std::size_t>(capacity / (SLOTS * 0.95)) + 1;
+    bucket_count = 1;
+    while (bucket_count < needed) bucket_count *= 2;
+    buckets = new bucket_t[bucket_count];
+    std::memset(static_cast<void*>(buckets), 0, bucket_count * sizeof(bucket_t));
+}
+
+template<typename var_type, typename fingerprint_t, typename Hash>
+bool CuckooFilter<var_type, fingerprint_t, Hash>::add(const var_type& var){
+    // with a fingerprint left over, one more kick chain could lose it
+    if (has_victim) return false;
+
+    fingerprint_t fingerprint;
+    std::size_t index;
+    locate(var, fingerprint, index);
+    element_count++;
+    if (put(index, fingerprint)) return true;
+    index = alternate(index, fingerprint);
+    if (put(index, fingerprint)) return true;
+
+    // both buckets are full, kicking random fingerprints to their other bucket
+    for (int kick = 0; kick < MAX_KICKS; kick++){
+        int slot = static_cast<int>(next_random() % SLOTS);
+        fingerprint_t kicked = slot_of(buckets[index], slot);
+        set_slot(buckets[index], slot, fingerprint);
+        fingerprint = kicked;
+        index = alternate(index, fingerprint);
+        if (put(index, fingerprint)) return true;
+    }
+
+    // the last kicked fingerprint stays findable, the filter is full from now on
+    has_victim = true;
+    victim = fingerprint;
+    victim_index = index;
+    return false;
+}
+
+template<typename var_type, typename fingerprint_t, typename Hash>
+bool CuckooFilter<var_type, fingerprint_t, Hash>::is_in(const var_type& var) const{
+    fingerprint_t fingerprint;
+    std::size_t index;
+    locate(var, fingerprint, index);
+    std::size_t other = alternate(index, fingerprint);
+
+    if (bucket_has(buckets[index], fingerprint) || bucket_has(buckets[other], fingerprint)) return true;
+    return has_victim && victim == fingerprint && (victim_index == index || victim_index == other);
+}
+
+template<typename var_type, typename fingerprint_t, typename Hash>
+void CuckooFilter<var_type, fingerprint_t, Hash>::pop(const var_type& var){
+    if (!erase(var)) throw std::logic_error("this variable isn't here!!!");
+}
+
+template<typename var_type, typename fingerprint_t, typename Hash>
+bool CuckooFilter<var_type, fingerprint_t, Hash>::erase(const var_type& var){
+    fingerprint_t fingerprint;
+    std::size_t index;
+    locate(var, fingerprint, index);
+    std::size_t other = alternate(index, fingerprint);
+
+    bool removed = false;
+    if (has_victim && victim == fingerprint && (victim_index == index || victim_index == other)){
+        has_victim = false;
+        removed = true;
+    } else {
+        removed = remove_from(index, fingerprint) || remove_from(other, fingerprint);
+    }
+    if (!removed) return false;
+    element_count--;
+
+    // a slot may have opened up for the left-over fingerprint
+    if (has_victim && (put(victim_index, victim) || put(alternate(victim_index, victim), victim))) has_victim = false;
+    return true;
+}
+
+#endif //LEARNING_CUCKOOFILTER_H
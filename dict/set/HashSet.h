@@ -3,8 +3,19 @@
 //
 #include <iostream>
 #include <type_traits>
+#include <cmath>
+#include <iterator>
+#include <cstddef>
+#include <atomic>
+#include <exception>
+#include <vector>
 
 #include "LinkedList.h"
+#include "../HashPolicy.h"
+#include "../Hashing.h"
+#include "../NodePool.h"
+#include "../Parallel.h"
+#include "../BlockedBloomFilter.h"
 
 #ifndef LEARNING_HASHSET_H
 #define LEARNING_HASHSET_H
@@ -14,18 +25,47 @@
  * @brief A templated HashSet class implementing a hash set using separate chaining.
  *
  * This class provides functionality to add, check and remove elements from the set.
- * It automatically resizes when the occupancy exceeds 75% to maintain efficiency.
+ * It automatically resizes when the load factor (elements per bucket) exceeds the maximum
+ * load factor, 0.75 by default. reserve() presizes the table for a known number of elements,
+ * and with set_auto_shrink(true) the table also shrinks once it becomes sparse.
+ *
+ * The bucket count is a prime by default. set_sizing_mode(SizingMode::POWER_OF_TWO) switches
+ * an instance to power-of-two bucket counts, where a hash is mapped to its bucket with a
+ * multiply and a shift instead of an integer division.
+ *
+ * Chain nodes come from a NodePool owned by the instance, so inserts and pops rarely touch
+ * the global allocator.
+ *
+ * With set_bloom_filter(true) a BlockedBloomFilter sits in front of the buckets and answers
+ * most lookups of absent elements with a single cache line read.
  *
  * @tparam var_type The type of elements stored in the HashSet.
+ * @tparam Hash The hash functor, DefaultHash<var_type> by default.
+ * @tparam KeyEqual The element comparison functor, std::equal_to<var_type> by default.
  */
-template<typename var_type>
+template<typename var_type, typename Hash = DefaultHash<var_type>, typename KeyEqual = std::equal_to<var_type>>
 class HashSet {
 protected:
     int real_size;                 /**< The current size of the hash table. */
     int element_count;             /**< The number of elements currently in the hash set. */
     int curr_pow_for_primes;       /**< The current power used to determine the next prime size. */
+    SizingMode sizing_mode;        /**< How the bucket count is chosen and hashes are mapped to buckets. */
+
+    float max_load_factor;         /**< The largest allowed number of elements per bucket. */
+    bool auto_shrink;              /**< Whether erasing elements can shrink the table. */
+    int grow_threshold;            /**< The table grows when element_count exceeds this. */
+    int shrink_threshold;          /**< With auto_shrink, the table shrinks when element_count drops below this. */
+
+    static const int MIN_SIZE = 5; /**< The smallest bucket count, also the initial one. */
 
     LinkedList<var_type>* element_arr; /**< Array of linked lists for separate chaining. */
+    NodePool<ListEl<var_type>> pool;   /**< Storage of all chain nodes of this set. */
+
+    BlockedBloomFilter filter;     /**< Rejects most lookups of absent elements, empty unless enabled. */
+    int filter_stale;              /**< Elements erased since the filter was last built, still set in it. */
+
+    Hash hasher;                   /**< The hash functor. */
+    KeyEqual key_equal;            /**< The element comparison functor. */
 
 public:
 
@@ -33,8 +73,11 @@ public:
      * @brief Default constructor.
      *
      * Initializes the hash set with a default size and sets up the linked lists.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The element comparison functor to use.
      */
-    HashSet();
+    explicit HashSet(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
 
     /**
      * @brief Destructor.
@@ -42,9 +85,36 @@ public:
      * Cleans up the allocated memory for the hash table.
      */
     ~HashSet(){
+        if (element_arr == no_buckets()) return;
+        destroy_nodes();
         delete[] element_arr;
     }
 
+    /**
+     * @brief Move constructor.
+     *
+     * Takes over the table and the nodes of other, which is left as an empty set. Nothing is
+     * allocated: other allocates a bucket array again with its next add.
+     *
+     * @param other The set to move from.
+     */
+    HashSet(HashSet&& other) noexcept;
+
+    /**
+     * @brief Move assignment.
+     *
+     * Frees the elements of this set and takes over the table and the nodes of other, which
+     * is left as an empty set, as with the move constructor. Makes
+     * @code
+     * result = a.intersect(b);
+     * @endcode
+     * work without copying.
+     *
+     * @param other The set to move from.
+     * @return HashSet& This set.
+     */
+    HashSet& operator=(HashSet&& other) noexcept;
+
 
     /**
      * @brief Adds an element to the HashSet.
@@ -62,7 +132,141 @@ public:
      * @return true If the element is present.
      * @return false Otherwise.
      */
-    bool is_in(var_type var);
+    bool is_in(var_type var) const;
+
+    /**
+     * @brief Finds an element of the HashSet.
+     *
+     * Hashes the element once and walks one chain.
+     *
+     * @param var The element to look for.
+     * @return const var_type* Pointer to the stored element, or nullptr if it is not present.
+     */
+    const var_type* find(const var_type& var) const;
+
+    /**
+     * @brief Removes an element if it is present.
+     *
+     * The non-throwing counterpart of pop().
+     *
+     * @param var The element to be removed.
+     * @return true If the element was found and removed.
+     * @return false If the element was not present.
+     */
+    bool erase(const var_type& var);
+
+    /**
+     * @brief Checks a batch of elements at once.
+     *
+     * Elements are processed in groups of PREFETCH_GROUP: the whole group is hashed and its
+     * buckets are prefetched, then the first node of every bucket, and only then is each
+     * element resolved, so the memory latencies of a group overlap.
+     *
+     * @param vars Pointer to the elements.
+     * @param count The number of elements.
+     * @param results Output array of count flags, results[i] tells whether vars[i] is present.
+     */
+    void contains_many(const var_type* vars, std::size_t count, bool* results) const;
+
+    /**
+     * @brief Finds a batch of elements at once, in groups like contains_many.
+     *
+     * @param vars Pointer to the elements.
+     * @param count The number of elements.
+     * @param results Output array of count pointers to the stored elements, nullptr for missing ones.
+     */
+    void find_many(const var_type* vars, std::size_t count, const var_type** results) const;
+
+    /**
+     * @brief Adds a batch of elements at once.
+     *
+     * Reserves room for all elements first, so the table grows at most once, and then inserts
+     * them in groups like contains_many.
+     *
+     * @param vars Pointer to the elements.
+     * @param count The number of elements.
+     */
+    void add_many(const var_type* vars, std::size_t count);
+
+    /**
+     * @brief Adds a range of elements using several threads.
+     *
+     * The table is sized for the final element count once. All elements are then hashed in
+     * parallel and grouped by bucket range, and every thread links the elements of its own
+     * buckets with nodes from its own NodePool, without locks. The pools are merged into the
+     * set's pool at the end.
+     *
+     * Hash, KeyEqual and the copy constructor of var_type are called from several threads at
+     * once. Small ranges are built on the calling thread only.
+     *
+     * @param begin Random access iterator to the first element.
+     * @param end Iterator past the last element.
+     * @param threads The number of threads, 0 for one per hardware thread.
+     */
+    template<typename RandomIt>
+    void build_parallel(RandomIt begin, RandomIt end, int threads = 0);
+
+    /**
+     * @brief Builds the union of this set and another one.
+     *
+     * The result starts from all elements of the larger set, and only the elements of the
+     * smaller set are probed, so the result is sized exactly once.
+     *
+     * All set operations keep both operands unchanged, and the result uses the functors, the
+     * sizing mode and the maximum load factor of this set. With more than one thread the
+     * buckets of the scanned set are split into ranges, one range per thread, and the result
+     * is filled like build_parallel.
+     *
+     * @param other The other set.
+     * @param threads The number of threads, 1 by default, 0 for one per hardware thread.
+     * @return HashSet The elements that are in at least one of the sets.
+     */
+    HashSet union_with(const HashSet& other, int threads = 1) const;
+
+    /**
+     * @brief Builds the intersection of this set and another one.
+     *
+     * Only the smaller set is scanned, and each of its elements is probed in the larger one.
+     *
+     * @param other The other set.
+     * @param threads The number of threads, 1 by default, 0 for one per hardware thread.
+     * @return HashSet The elements that are in both sets.
+     */
+    HashSet intersect(const HashSet& other, int threads = 1) const;
+
+    /**
+     * @brief Builds the difference of this set and another one.
+     *
+     * When other is the smaller set, the result is a copy of this set with the elements of
+     * other erased, so only other is probed. Otherwise this set is scanned and probed in other.
+     *
+     * @param other The other set.
+     * @param threads The number of threads, 1 by default, 0 for one per hardware thread.
+     * @return HashSet The elements of this set that are not in other.
+     */
+    HashSet difference(const HashSet& other, int threads = 1) const;
+
+    /**
+     * @brief Builds the symmetric difference of this set and another one.
+     *
+     * @param other The other set.
+     * @param threads The number of threads, 1 by default, 0 for one per hardware thread.
+     * @return HashSet The elements that are in exactly one of the sets.
+     */
+    HashSet symmetric_difference(const HashSet& other, int threads = 1) const;
+
+    /**
+     * @brief Checks if every element of this set is in another one.
+     *
+     * A larger set is never a subset, so that case costs no probe at all. The scan stops at
+     * the first missing element, in every thread.
+     *
+     * @param other The other set.
+     * @param threads The number of threads, 1 by default, 0 for one per hardware thread.
+     * @return true If this set is a subset of other.
+     * @return false Otherwise.
+     */
+    bool is_subset_of(const HashSet& other, int threads = 1) const;
 
     /**
      * @brief Removes an element from the HashSet.
@@ -83,6 +287,221 @@ public:
         return element_count;
     }
 
+    /**
+     * @brief Switches the way the bucket count is chosen and hashes are mapped to buckets.
+     *
+     * The table is rebuilt right away: for POWER_OF_TWO the bucket count is rounded up to a
+     * power of two, for PRIME the next resize goes back to prime sizes.
+     *
+     * @param mode The new sizing mode.
+     */
+    void set_sizing_mode(SizingMode mode);
+
+    /**
+     * @brief Retrieves the current sizing mode.
+     *
+     * @return SizingMode The sizing mode of this instance.
+     */
+    [[nodiscard]] SizingMode get_sizing_mode() const {
+        return sizing_mode;
+    }
+
+    /**
+     * @brief Presizes the table so that count elements fit without any further resize.
+     *
+     * Never shrinks the table. Call it before a bulk load of a known size.
+     *
+     * @param count The number of elements the table should hold.
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Rebuilds the table with at least bucket_count buckets.
+     *
+     * The bucket count is raised to what the current elements need under the maximum load
+     * factor and then rounded up to a prime or a power of two, depending on the sizing mode.
+     *
+     * @param bucket_count The requested number of buckets.
+     */
+    void rehash(int bucket_count);
+
+    /**
+     * @brief Shrinks the table to the smallest bucket count that fits the current elements.
+     */
+    void shrink_to_fit();
+
+    /**
+     * @brief Retrieves the current size of the hash table.
+     *
+     * @return int The size of the hash table.
+     */
+    [[nodiscard]] int getTrueSize() const {
+        return real_size;
+    }
+
+    /**
+     * @brief Retrieves the current load factor.
+     *
+     * @return float The number of elements per bucket.
+     */
+    [[nodiscard]] float load_factor() const {
+        return static_cast<float>(element_count) / real_size;
+    }
+
+    /**
+     * @brief Retrieves the maximum load factor.
+     *
+     * @return float The largest allowed number of elements per bucket.
+     */
+    [[nodiscard]] float get_max_load_factor() const {
+        return max_load_factor;
+    }
+
+    /**
+     * @brief Sets the maximum load factor, growing the table right away if it is exceeded.
+     *
+     * @param factor The largest allowed number of elements per bucket.
+     * @throws std::logic_error If factor is not positive.
+     */
+    void set_max_load_factor(float factor);
+
+    /**
+     * @brief Enables or disables automatic shrinking.
+     *
+     * When enabled, the table shrinks to half full once the load factor drops below a quarter
+     * of the maximum one, see HashDict::set_auto_shrink.
+     *
+     * @param enabled true to let erase() and pop() shrink the table.
+     */
+    void set_auto_shrink(bool enabled){
+        auto_shrink = enabled;
+        update_thresholds();
+    }
+
+    /**
+     * @brief Enables or disables the Bloom filter in front of lookups.
+     *
+     * When most lookups are for absent elements, the filter rejects them after reading one
+     * cache line, without touching the bucket array or any chain. It costs bits_per_key bits
+     * per element of capacity and one more cache line write per add. The filter is rebuilt
+     * whenever the table is, and after many erases, because erased elements stay set in it.
+     *
+     * @param enabled true to keep and consult the filter.
+     * @param bits_per_key Filter bits per element. 10 rejects about 99% of absent elements.
+     */
+    void set_bloom_filter(bool enabled, int bits_per_key = 10);
+
+    /**
+     * @brief Checks if the Bloom filter is enabled.
+     *
+     * @return true If lookups consult the filter.
+     * @return false Otherwise.
+     */
+    [[nodiscard]] bool has_bloom_filter() const {
+        return filter.is_active();
+    }
+
+    /**
+     * @brief A forward iterator over all elements of the HashSet.
+     *
+     * Walks the buckets and their chains once, so a full scan is O(n + number of buckets).
+     * Elements are read-only, since changing one would move it to another bucket. Any add,
+     * erase or resize invalidates all iterators.
+     */
+    class ConstIterator {
+    private:
+        const HashSet* set;                 /**< The set being iterated. */
+        int bucket;                         /**< The index of the current bucket. */
+        const ListEl<var_type>* current;    /**< The current node, nullptr at the end. */
+
+        friend class HashSet;
+
+        ConstIterator(const HashSet* owner, int bucket_index, const ListEl<var_type>* node)
+                : set(owner), bucket(bucket_index), current(node) {}
+
+        /**
+         * @brief Moves forward to the first node of the next non-empty bucket if there is no current node.
+         */
+        void settle(){
+            while (current == nullptr && ++bucket < set->real_size) current = set->element_arr[bucket].first_el;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = var_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const var_type*;
+        using reference = const var_type&;
+
+        ConstIterator() : set(nullptr), bucket(0), current(nullptr) {}
+
+        /**
+         * @brief Dereferences the iterator to access the current element.
+         *
+         * @return const var_type& Reference to the current element.
+         */
+        const var_type& operator*() const {
+            return current->var;
+        }
+
+        const var_type* operator->() const {
+            return &current->var;
+        }
+
+        /**
+         * @brief Advances the iterator to the next element.
+         *
+         * @return ConstIterator& Reference to the updated iterator.
+         */
+        ConstIterator& operator++(){
+            current = current->next_pointer;
+            settle();
+            return *this;
+        }
+
+        /**
+         * @brief Advances the iterator to the next element (postfix version).
+         *
+         * @return ConstIterator The iterator before the increment.
+         */
+        ConstIterator operator++(int){
+            ConstIterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return current == other.current;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return current != other.current;
+        }
+    };
+
+    using iterator = ConstIterator;
+    using const_iterator = ConstIterator;
+
+    /**
+     * @brief Returns an iterator to the first element.
+     *
+     * @return ConstIterator An iterator to the first element, equal to end() if the HashSet is empty.
+     */
+    ConstIterator begin() const {
+        ConstIterator it(this, -1, nullptr);
+        it.settle();
+        return it;
+    }
+
+    /**
+     * @brief Returns an iterator past the last element.
+     *
+     * @return ConstIterator The end iterator.
+     */
+    ConstIterator end() const {
+        return ConstIterator(this, real_size, nullptr);
+    }
+
     /**
      * @brief Prints the contents of the HashSet.
      *
@@ -96,78 +515,205 @@ public:
 protected:
 
     /**
-     * @brief Computes the hash for integral types.
+     * @brief Computes the hash of an element with the Hash functor.
+     *
+     * @param var The element to hash.
+     * @return std::size_t The computed hash.
+     */
+    std::size_t getHash(const var_type& var) const {
+        return hasher(var);
+    }
+
+    /**
+     * @brief Finds the bucket index of a hash in a bucket array of the given size.
      *
-     * Uses bitwise operations to generate a hash value for integers.
+     * @param hash The hash of the element.
+     * @param size The size of the bucket array.
+     * @return int The bucket index.
+     */
+    int position_of(std::size_t hash, int size) const {
+        return map_to_bucket(hash, size, sizing_mode);
+    }
+
+    /**
+     * @brief Retrieves the hash of the element stored in a node.
+     *
+     * Uses the cached hash when the node has one and hashes the element again otherwise.
+     *
+     * @param node The node.
+     * @return std::size_t The hash of the node's element.
+     */
+    std::size_t node_hash(const ListEl<var_type>* node) const {
+        if constexpr (should_cache_hash<var_type>::value) return node->hash;
+        else return getHash(node->var);
+    }
+
+    /**
+     * @brief Finds the node holding an element inside one bucket.
+     *
+     * Elements are compared with the KeyEqual functor. When nodes cache their hash, the hashes
+     * are compared first, so the element comparison runs only for real candidates.
+     *
+     * @param bucket The bucket to search.
+     * @param var The element to search for.
+     * @param hash The hash of the element.
+     * @param previous_element If not nullptr, set to the node before the found one (nullptr for the first node).
+     * @return ListEl<var_type>* The node holding the element, or nullptr if it is not in the bucket.
+     */
+    ListEl<var_type>* find_in_bucket(const LinkedList<var_type>& bucket, const var_type& var, std::size_t hash,
+                                     ListEl<var_type>** previous_element = nullptr) const;
+
+    /**
+     * @brief Recomputes grow_threshold and shrink_threshold for the current size.
+     */
+    void update_thresholds(){
+        // the shared empty bucket is never written to, the first add allocates a real array
+        grow_threshold = element_arr == no_buckets() ? -1 : static_cast<int>(real_size * max_load_factor);
+        shrink_threshold = auto_shrink ? static_cast<int>(real_size * max_load_factor / 4) : 0;
+    }
+
+    /**
+     * @brief The single empty bucket shared by all moved-from sets, so that moving allocates nothing.
+     */
+    static LinkedList<var_type>* no_buckets(){
+        static LinkedList<var_type> empty;
+        return &empty;
+    }
+
+    /**
+     * @brief Turns a moved-from set into an empty one on no_buckets().
+     */
+    void become_empty(){
+        element_arr = no_buckets();
+        real_size = 1;
+        element_count = 0;
+        filter_stale = 0;
+        curr_pow_for_primes = 3;
+        sizing_mode = SizingMode::PRIME;
+        update_thresholds();
+    }
+
+    /**
+     * @brief Chooses the smallest valid bucket count that is at least the given one.
      *
-     * @tparam T Integral type.
-     * @param value The value to hash.
-     * @return long long int The computed hash.
+     * In PRIME mode this is the next prime, and the prime sequence of later resizes continues
+     * from it. In POWER_OF_TWO mode it is the next power of two.
+     *
+     * @param bucket_count The requested number of buckets.
+     * @return long long The bucket count to use.
      */
-    template <typename T>
-    typename std::enable_if<std::is_integral<T>::value, long long int>::type
-    getHash(T value);
+    long long fit_size(long long bucket_count);
 
     /**
-     * @brief Computes the hash for floating-point types.
+     * @brief Rebuilds the table with exactly new_size buckets.
      *
-     * Processes the binary representation of floating-point numbers to generate a hash.
+     * @param new_size The new number of buckets.
+     */
+    void rebuild(long long new_size);
+
+    /**
+     * @brief Resizes the hash table by creating a new array with a larger prime size.
      *
-     * @tparam T Floating-point type.
-     * @param value The value to hash.
-     * @return long long int The computed hash.
+     * Allocates a new array, rehashes existing elements and replaces the old array.
      */
-    template <typename T>
-    typename std::enable_if<std::is_floating_point<T>::value, long long int>::type
-    getHash(T value);
+    void create_new_elements_arr();
 
+    /**
+     * @brief Links a new node for an already hashed element unless it is present.
+     *
+     * @param hash The hash of the element.
+     * @param var The element, const var_type& or var_type&&.
+     */
+    template<typename V>
+    void add_hashed(std::size_t hash, V&& var);
 
     /**
-     * @brief Computes the hash for pointer types.
+     * @brief Adds count elements, using several threads for large counts.
      *
-     * Hashes the memory address of the pointer.
+     * The common part of build_parallel and the set operations.
      *
-     * @tparam T Pointer type.
-     * @param value The pointer to hash.
-     * @return long long int The computed hash.
+     * @param count The number of elements.
+     * @param item_at Called as item_at(std::size_t index), returns the element at the index. Must be thread-safe.
+     * @param threads The requested number of threads, 0 for one per hardware thread.
      */
-    template <typename T>
-    typename std::enable_if<std::is_pointer<T>::value, long long int>::type
-    getHash(T value);
+    template<typename ItemAt>
+    void bulk_insert(std::size_t count, ItemAt&& item_at, int threads);
 
     /**
-     * @brief Computes the hash for std::string.
+     * @brief Sizes the Bloom filter for a bucket count and clears it, if the filter is enabled.
      *
-     * Processes each character in the string to generate a hash.
+     * The caller adds the elements again, copy_list does that while it relinks them.
      *
-     * @param value The string to hash.
-     * @return long long int The computed hash.
+     * @param bucket_count The bucket count the table is about to have.
      */
-    long long int getHash(const std::string& value) const;
+    void reset_filter(long long bucket_count);
 
     /**
-     * @brief Calculates the current occupancy of the hash table.
+     * @brief Builds the Bloom filter from the current elements, dropping the erased ones.
      *
-     * Determines the percentage of filled elements relative to the total size.
+     * Also enables the filter if it was not, so callers check has_bloom_filter() first.
+     */
+    void rebuild_filter();
+
+    /**
+     * @brief Checks if this set holds the element of a node of another set.
      *
-     * @return float The occupancy percentage.
+     * With a stateless Hash both sets hash alike, so the cached hash of the node is reused.
+     *
+     * @param owner The set the node belongs to.
+     * @param node The node.
+     * @return true If the element is present in this set.
+     * @return false Otherwise.
      */
-    float get_occupancy(){
-        if (HashSet<var_type>::real_size == 0) return 0;
-        return ((float)HashSet<var_type>::element_count / HashSet<var_type>::real_size) * 100;
+    bool has_element_of(const HashSet& owner, const ListEl<var_type>* node) const {
+        std::size_t hash;
+        if constexpr (std::is_empty<Hash>::value) hash = owner.node_hash(node);
+        else hash = getHash(node->var);
+        return find_in_bucket(element_arr[position_of(hash, real_size)], node->var, hash) != nullptr;
     }
 
     /**
-     * @brief Resizes the hash table by creating a new array with a larger prime size.
+     * @brief Appends pointers to the elements that pass a filter.
      *
-     * Allocates a new array, rehashes existing elements and replaces the old array.
+     * With more than one thread every thread scans its own range of buckets, and the results
+     * are appended in bucket order.
+     *
+     * @param threads The requested number of threads, 0 for one per hardware thread.
+     * @param out The vector to append to.
+     * @param keep Called as keep(const ListEl<var_type>*), true to take the element. Must be thread-safe.
      */
-    void create_new_elements_arr();
+    template<typename Keep>
+    void collect(int threads, std::vector<const var_type*>& out, Keep&& keep) const;
 
     /**
-     * @brief Copies all elements from the old hash table to the new one.
+     * @brief Creates an empty set with the functors, the sizing mode and the maximum load factor of this one.
      *
-     * Rehashes each element and inserts it into the appropriate linked list in the new array.
+     * @return HashSet The empty set.
+     */
+    HashSet make_empty_like() const;
+
+    /**
+     * @brief Hashes a group of elements and prefetches their buckets and the first node of each.
+     *
+     * @param vars Pointer to the elements of the group.
+     * @param count The number of elements, at most PREFETCH_GROUP.
+     * @param hashes Output array of the hashes.
+     * @param buckets Output array of the buckets.
+     */
+    void prefetch_group(const var_type* vars, std::size_t count, std::size_t* hashes, const LinkedList<var_type>** buckets) const;
+
+    /**
+     * @brief Gives every node back to the pool, leaving all buckets empty.
+     *
+     * Must run before the bucket array is deleted, because the buckets do not own pooled nodes.
+     */
+    void destroy_nodes();
+
+    /**
+     * @brief Moves all elements from the old hash table to the new one.
+     *
+     * Every node is unlinked from its old chain and linked in front of its new chain, so
+     * resizing is linear in the number of elements and allocates or copies nothing.
      *
      * @param new_lst Pointer to the new array of linked lists.
      * @param new_size The size of the new array.
@@ -175,6 +721,18 @@ protected:
     void copy_list(LinkedList<var_type>* new_lst, int new_size);
 
 
+    /**
+     * @brief Chooses the bucket count for the next resize.
+     *
+     * Doubles the size in POWER_OF_TWO mode and takes the next prime otherwise.
+     *
+     * @return long long The new size.
+     */
+    long long next_size(){
+        if (sizing_mode == SizingMode::POWER_OF_TWO) return (long long)real_size * 2;
+        return next_prime();
+    }
+
     /**
      * @brief Finds the next prime number for resizing the hash table.
      *
@@ -211,197 +769,552 @@ protected:
 
 // methods implementation
 
-template<typename var_type>
-HashSet<var_type>::HashSet() {
-    real_size = 5;
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual>::HashSet(const Hash& hash, const KeyEqual& equal) : filter_stale(0), hasher(hash), key_equal(equal) {
+    real_size = MIN_SIZE;
     element_count = 0;
     curr_pow_for_primes = 3;
+    sizing_mode = SizingMode::PRIME;
+    max_load_factor = 0.75f;
+    auto_shrink = false;
     element_arr = new LinkedList<var_type>[real_size];
-    for (int i = 0; i < 5; i++) element_arr[i].first_el = nullptr;
+    for (int i = 0; i < real_size; i++) element_arr[i].first_el = nullptr;
+    update_thresholds();
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual>::HashSet(HashSet&& other) noexcept
+        : real_size(other.real_size), element_count(other.element_count), curr_pow_for_primes(other.curr_pow_for_primes),
+          sizing_mode(other.sizing_mode), max_load_factor(other.max_load_factor), auto_shrink(other.auto_shrink),
+          grow_threshold(other.grow_threshold), shrink_threshold(other.shrink_threshold), element_arr(other.element_arr),
+          pool(std::move(other.pool)), filter(std::move(other.filter)), filter_stale(other.filter_stale),
+          hasher(other.hasher), key_equal(other.key_equal) {
+    other.become_empty();
 }
 
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual>& HashSet<var_type, Hash, KeyEqual>::operator=(HashSet&& other) noexcept{
+    if (&other == this) return *this;
+    if (element_arr != no_buckets()){
+        destroy_nodes();
+        delete[] element_arr;
+    }
 
-template<typename var_type>
-void HashSet<var_type>::add(var_type var){
+    real_size = other.real_size;
+    element_count = other.element_count;
+    curr_pow_for_primes = other.curr_pow_for_primes;
+    sizing_mode = other.sizing_mode;
+    max_load_factor = other.max_load_factor;
+    auto_shrink = other.auto_shrink;
+    grow_threshold = other.grow_threshold;
+    shrink_threshold = other.shrink_threshold;
+    element_arr = other.element_arr;
+    pool = std::move(other.pool);
+    filter = std::move(other.filter);
+    filter_stale = other.filter_stale;
+    hasher = other.hasher;
+    key_equal = other.key_equal;
+
+    other.become_empty();
+    return *this;
+}
 
-    if (get_occupancy() > 75)
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::add(var_type var){
+
+    if (element_count > grow_threshold)
         create_new_elements_arr();
 
-//    std::cout << var << " hash started" << std::endl;
-    long long int  hash = HashSet<var_type>::getHash(var);
+    std::size_t hash = HashSet<var_type, Hash, KeyEqual>::getHash(var);
+    add_hashed(hash, std::move(var));
+}
 
-    if (hash < 0) hash = -hash;
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::contains_many(const var_type* vars, std::size_t count, bool* results) const{
+    std::size_t hashes[PREFETCH_GROUP];
+    const LinkedList<var_type>* buckets[PREFETCH_GROUP];
 
-    int position = hash % real_size;
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(vars + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++)
+            results[start + i] = filter.may_contain(hashes[i]) && find_in_bucket(*buckets[i], vars[start + i], hashes[i]) != nullptr;
+    }
+}
 
-    element_arr[position].add(var);
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::find_many(const var_type* vars, std::size_t count, const var_type** results) const{
+    std::size_t hashes[PREFETCH_GROUP];
+    const LinkedList<var_type>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(vars + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++){
+            ListEl<var_type>* element = filter.may_contain(hashes[i]) ? find_in_bucket(*buckets[i], vars[start + i], hashes[i]) : nullptr;
+            results[start + i] = element == nullptr ? nullptr : &element->var;
+        }
+    }
+}
 
-    element_count++;
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::add_many(const var_type* vars, std::size_t count){
+    // growing once up front, a resize in the middle of a group would waste its prefetches
+    HashSet<var_type, Hash, KeyEqual>::reserve(static_cast<int>(element_count + count));
+
+    std::size_t hashes[PREFETCH_GROUP];
+    const LinkedList<var_type>* buckets[PREFETCH_GROUP];
+
+    for (std::size_t start = 0; start < count; start += PREFETCH_GROUP){
+        std::size_t group = count - start < PREFETCH_GROUP ? count - start : PREFETCH_GROUP;
+        prefetch_group(vars + start, group, hashes, buckets);
+        for (std::size_t i = 0; i < group; i++) add_hashed(hashes[i], vars[start + i]);
+    }
 }
 
-template<typename var_type>
-bool HashSet<var_type>::is_in(var_type var){
-    long long hash = getHash(var);
+template<typename var_type, typename Hash, typename KeyEqual>
+template<typename RandomIt>
+void HashSet<var_type, Hash, KeyEqual>::build_parallel(RandomIt begin, RandomIt end, int threads){
+    static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>::value,
+                  "build_parallel needs random access iterators");
+    bulk_insert(static_cast<std::size_t>(end - begin), [&begin](std::size_t i) -> decltype(auto) { return begin[i]; }, threads);
+}
 
-    if(hash < 0)
-        hash = -hash;
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual> HashSet<var_type, Hash, KeyEqual>::union_with(const HashSet& other, int threads) const{
+    const HashSet& larger = element_count >= other.element_count ? *this : other;
+    const HashSet& smaller = element_count >= other.element_count ? other : *this;
 
-    long long position = hash % real_size;
+    std::vector<const var_type*> items;
+    larger.collect(threads, items, [](const ListEl<var_type>*){ return true; });
+    smaller.collect(threads, items, [&larger, &smaller](const ListEl<var_type>* node){ return !larger.has_element_of(smaller, node); });
 
-    return element_arr[position].is_in(var);
+    HashSet<var_type, Hash, KeyEqual> result = make_empty_like();
+    result.bulk_insert(items.size(), [&items](std::size_t i) -> const var_type& { return *items[i]; }, threads);
+    return result;
 }
 
-template<typename var_type>
-void HashSet<var_type>::pop(var_type var){
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual> HashSet<var_type, Hash, KeyEqual>::intersect(const HashSet& other, int threads) const{
+    const HashSet& larger = element_count >= other.element_count ? *this : other;
+    const HashSet& smaller = element_count >= other.element_count ? other : *this;
 
-    int hash = HashSet<var_type>::getHash(var);
-    int position = hash % HashSet<var_type>::real_size;
-    // if element_arr[i] is not empty, overloaded operator, look to LinkedList.h
-    if (HashSet<var_type>::element_arr[position] != nullptr){
-        element_arr[position].pop(var);
-        element_count --;
-    } else{
-        throw std::logic_error("no elements here!!!");
-    }
+    std::vector<const var_type*> items;
+    smaller.collect(threads, items, [&larger, &smaller](const ListEl<var_type>* node){ return larger.has_element_of(smaller, node); });
+
+    HashSet<var_type, Hash, KeyEqual> result = make_empty_like();
+    result.bulk_insert(items.size(), [&items](std::size_t i) -> const var_type& { return *items[i]; }, threads);
+    return result;
 }
 
-template<typename var_type>
-void HashSet<var_type>::print(std::ostream& out) const {
-    for (int i = 0; i < real_size; i++) {
-        if (element_arr[i] == nullptr) continue;
-        out << element_arr[i] << " ";
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual> HashSet<var_type, Hash, KeyEqual>::difference(const HashSet& other, int threads) const{
+    std::vector<const var_type*> items;
+    bool erase_other = other.element_count < element_count;
+    if (erase_other) collect(threads, items, [](const ListEl<var_type>*){ return true; });
+    else collect(threads, items, [this, &other](const ListEl<var_type>* node){ return !other.has_element_of(*this, node); });
+
+    HashSet<var_type, Hash, KeyEqual> result = make_empty_like();
+    result.bulk_insert(items.size(), [&items](std::size_t i) -> const var_type& { return *items[i]; }, threads);
+    if (erase_other){
+        // shrinking in the middle would only rebuild the table again and again
+        result.auto_shrink = false;
+        result.update_thresholds();
+        for (const var_type& var : other) result.erase(var);
+        result.set_auto_shrink(auto_shrink);
     }
+    return result;
 }
 
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual> HashSet<var_type, Hash, KeyEqual>::symmetric_difference(const HashSet& other, int threads) const{
+    std::vector<const var_type*> items;
+    collect(threads, items, [this, &other](const ListEl<var_type>* node){ return !other.has_element_of(*this, node); });
+    other.collect(threads, items, [this, &other](const ListEl<var_type>* node){ return !has_element_of(other, node); });
 
-//protected
+    HashSet<var_type, Hash, KeyEqual> result = make_empty_like();
+    result.bulk_insert(items.size(), [&items](std::size_t i) -> const var_type& { return *items[i]; }, threads);
+    return result;
+}
 
-//hash functions
+template<typename var_type, typename Hash, typename KeyEqual>
+bool HashSet<var_type, Hash, KeyEqual>::is_subset_of(const HashSet& other, int threads) const{
+    if (element_count > other.element_count) return false;
+
+    int thread_number = thread_count_for(threads, element_count);
+    std::atomic<bool> missing(false);
+    parallel_for(thread_number, [&](int t){
+        int from = static_cast<int>((long long)real_size * t / thread_number);
+        int to = static_cast<int>((long long)real_size * (t + 1) / thread_number);
+        for (int i = from; i < to && !missing.load(std::memory_order_relaxed); i++){
+            for (ListEl<var_type>* curr_el = element_arr[i].first_el; curr_el != nullptr; curr_el = curr_el->next_pointer){
+                if (!other.has_element_of(*this, curr_el)){
+                    missing.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+    });
+    return !missing.load();
+}
 
-template<typename var_type>
-template <typename T>
-typename std::enable_if<std::is_integral<T>::value, long long int>::type
-HashSet<var_type>::getHash(T value) {
-    // hash function works only for positive nums
-    if (value < 0) {
-        value = -value;
-    }
-    long long int result = 0;
-    while (value) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= (value & 0xFF);
-        value >>= 8;
-    }
+template<typename var_type, typename Hash, typename KeyEqual>
+bool HashSet<var_type, Hash, KeyEqual>::is_in(var_type var) const{
+    return find(var) != nullptr;
+}
 
+template<typename var_type, typename Hash, typename KeyEqual>
+const var_type* HashSet<var_type, Hash, KeyEqual>::find(const var_type& var) const{
+    std::size_t hash = getHash(var);
+    // one cache line answers most misses
+    if (!filter.may_contain(hash)) return nullptr;
+    int position = position_of(hash, real_size);
 
-    return result;
+    ListEl<var_type>* element = find_in_bucket(element_arr[position], var, hash);
+    return element == nullptr ? nullptr : &element->var;
 }
 
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::pop(var_type var){
+    if (!erase(var)) throw std::logic_error("this variable isn't here!!!");
+}
 
-template<typename var_type>
-template <typename T>
-typename std::enable_if<std::is_floating_point<T>::value, long long int>::type
-HashSet<var_type>::getHash(T value) {
-    long long int result = 0;
-    unsigned char* bytePtr = reinterpret_cast<unsigned char*>(&value);
-    for (size_t i = 0; i < sizeof(T); ++i) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= bytePtr[i];
-    }
+template<typename var_type, typename Hash, typename KeyEqual>
+bool HashSet<var_type, Hash, KeyEqual>::erase(const var_type& var){
 
+    std::size_t hash = HashSet<var_type, Hash, KeyEqual>::getHash(var);
+    int position = HashSet<var_type, Hash, KeyEqual>::position_of(hash, HashSet<var_type, Hash, KeyEqual>::real_size);
+    ListEl<var_type>* previous_element = nullptr;
+    ListEl<var_type>* element_to_delete = find_in_bucket(element_arr[position], var, hash, &previous_element);
+    if (element_to_delete == nullptr) return false;
 
-    return result;
+    element_arr[position].unlink(previous_element, element_to_delete);
+    pool.destroy(element_to_delete);
+    element_count --;
+
+    // the table became sparse, shrinking it to half full
+    if (element_count < shrink_threshold){
+        long long new_size = fit_size(static_cast<long long>(element_count / max_load_factor * 2));
+        if (new_size < real_size) HashSet<var_type, Hash, KeyEqual>::rebuild(new_size);
+    }
+    // erased elements still pass the filter, once they are many it is built again
+    if (filter.is_active() && ++filter_stale > element_count / 2 + 16) rebuild_filter();
+    return true;
 }
 
-template<typename var_type>
-template <typename T>
-typename std::enable_if<std::is_pointer<T>::value, long long int>::type
-HashSet<var_type>::getHash(T value) {
-    long long int result = 0;
-    uintptr_t ptr = reinterpret_cast<uintptr_t>(value);
-    unsigned char* bytePtr = reinterpret_cast<unsigned char*>(&ptr);
-    for (size_t i = 0; i < sizeof(ptr); ++i) {
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= bytePtr[i];
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::print(std::ostream& out) const {
+    for (int i = 0; i < real_size; i++) {
+        if (element_arr[i] == nullptr) continue;
+        out << element_arr[i] << " ";
     }
+}
 
 
-    return result;
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::set_sizing_mode(SizingMode mode){
+    sizing_mode = mode;
+
+    long long new_size = real_size;
+    if (mode == SizingMode::POWER_OF_TWO) new_size = fit_size(real_size);
+
+    // every bucket index changes with the mapping, so the table is rebuilt even at the same size
+    HashSet<var_type, Hash, KeyEqual>::rebuild(new_size);
 }
 
-template<typename var_type>
-long long int HashSet<var_type>::getHash(const std::string& value) const {
-    long long int result = 0;
-    for (char c : value) {
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::reserve(int count){
+    long long needed = static_cast<long long>(std::ceil(count / max_load_factor)) + 1;
+    if (needed > real_size) HashSet<var_type, Hash, KeyEqual>::rehash(static_cast<int>(needed));
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::rehash(int bucket_count){
+    // never go below what the current elements need
+    long long needed = static_cast<long long>(std::ceil(element_count / max_load_factor)) + 1;
+    if (needed < bucket_count) needed = bucket_count;
+    HashSet<var_type, Hash, KeyEqual>::rebuild(fit_size(needed));
+}
 
-        result = (result << 5) | (result >> (sizeof(long long int) * 8 - 5));
-        result ^= static_cast<unsigned char>(c);
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::shrink_to_fit(){
+    HashSet<var_type, Hash, KeyEqual>::rehash(0);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::set_max_load_factor(float factor){
+    if (!(factor > 0)) throw std::logic_error("max load factor must be positive!!!");
+    max_load_factor = factor;
+    HashSet<var_type, Hash, KeyEqual>::update_thresholds();
+    if (element_count > grow_threshold) HashSet<var_type, Hash, KeyEqual>::rehash(0);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::set_bloom_filter(bool enabled, int bits_per_key){
+    filter.set_bits_per_key(bits_per_key);
+    if (!enabled){
+        filter.resize(0);
+        return;
     }
+    HashSet<var_type, Hash, KeyEqual>::rebuild_filter();
+}
 
 
-    return result;
+//protected
+
+template<typename var_type, typename Hash, typename KeyEqual>
+ListEl<var_type>* HashSet<var_type, Hash, KeyEqual>::find_in_bucket(const LinkedList<var_type>& bucket, const var_type& var, std::size_t hash,
+                                                                   ListEl<var_type>** previous_element) const{
+    ListEl<var_type>* previous = nullptr;
+    ListEl<var_type>* curr_el = bucket.first_el;
+    while (curr_el != nullptr){
+        bool candidate = true;
+        if constexpr (should_cache_hash<var_type>::value) candidate = curr_el->hash == hash;
+        if (candidate && key_equal(curr_el->var, var)){
+            if (previous_element != nullptr) *previous_element = previous;
+            return curr_el;
+        }
+        previous = curr_el;
+        curr_el = curr_el->next_pointer;
+    }
+    return nullptr;
 }
 
 // puffer scaling functions
-template<typename var_type>
-void HashSet<var_type>::create_new_elements_arr() {
-    long long new_size = HashSet<var_type>::next_prime();
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::create_new_elements_arr() {
+    long long new_size = HashSet<var_type, Hash, KeyEqual>::next_size();
 
     LinkedList<var_type>* new_element_arr = new LinkedList<var_type>[new_size];
-    HashSet<var_type>::copy_list(new_element_arr, new_size);
+    HashSet<var_type, Hash, KeyEqual>::reset_filter(new_size);
+    if (element_arr != no_buckets()){
+        HashSet<var_type, Hash, KeyEqual>::copy_list(new_element_arr, new_size);
+        delete[] HashSet<var_type, Hash, KeyEqual>::element_arr;
+    }
+
+    element_arr = new_element_arr;
+    HashSet<var_type, Hash, KeyEqual>::real_size = new_size;
+    HashSet<var_type, Hash, KeyEqual>::update_thresholds();
+}
 
-    delete[] HashSet<var_type>::element_arr;
+template<typename var_type, typename Hash, typename KeyEqual>
+long long HashSet<var_type, Hash, KeyEqual>::fit_size(long long bucket_count){
+    long long size = bucket_count < MIN_SIZE ? MIN_SIZE : bucket_count;
+    if (sizing_mode == SizingMode::POWER_OF_TWO){
+        long long power = 1;
+        while (power < size) power *= 2;
+        return power;
+    }
 
+    while (!HashSet<var_type, Hash, KeyEqual>::is_prime(size)) size++;
+    // the next automatic resize continues after this size, not after the largest one so far
+    curr_pow_for_primes = 0;
+    while ((2LL << curr_pow_for_primes) <= size) curr_pow_for_primes++;
+    return size;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::rebuild(long long new_size){
+    LinkedList<var_type>* new_element_arr = new LinkedList<var_type>[new_size];
+    HashSet<var_type, Hash, KeyEqual>::reset_filter(new_size);
+    if (element_arr != no_buckets()){
+        HashSet<var_type, Hash, KeyEqual>::copy_list(new_element_arr, new_size);
+        delete[] element_arr;
+    }
     element_arr = new_element_arr;
-    HashSet<var_type>::real_size = new_size;
+    real_size = new_size;
+    HashSet<var_type, Hash, KeyEqual>::update_thresholds();
 }
 
-template<typename var_type>
-void HashSet<var_type>::copy_list(LinkedList<var_type>* new_lst, int new_size){
-    // running through all buckets
-    for (int i = 0; i < real_size; i ++){
-        // if there is at least one element |look at the LinkedList|
-        if (HashSet<var_type>::element_arr[i] != nullptr){
-            // for all element in linked list
-            for (auto element: element_arr[i]){
+template<typename var_type, typename Hash, typename KeyEqual>
+template<typename V>
+void HashSet<var_type, Hash, KeyEqual>::add_hashed(std::size_t hash, V&& var){
+    int position = HashSet<var_type, Hash, KeyEqual>::position_of(hash, real_size);
 
-                long long int  hash = HashSet<var_type>::getHash(element);
+    if (find_in_bucket(element_arr[position], var, hash) != nullptr) return; // do nothing
 
-                if (hash < 0) hash = -hash;
+    ListEl<var_type>* new_el = pool.create(std::forward<V>(var));
+    if constexpr (should_cache_hash<var_type>::value) new_el -> hash = hash;
+    element_arr[position].link_front(new_el);
+    filter.insert(hash);
 
-                int position = hash % new_size;
+    element_count++;
+}
 
-                new_lst[position].add(element);
+template<typename var_type, typename Hash, typename KeyEqual>
+template<typename ItemAt>
+void HashSet<var_type, Hash, KeyEqual>::bulk_insert(std::size_t count, ItemAt&& item_at, int threads){
+    if (count == 0) return;
+    // every node goes straight into its final bucket, so no resize may follow
+    HashSet<var_type, Hash, KeyEqual>::reserve(static_cast<int>(element_count + count));
+
+    int thread_number = thread_count_for(threads, count);
+    if (thread_number == 1){
+        // nothing to partition for a single thread
+        for (std::size_t i = 0; i < count; i++) add_hashed(getHash(item_at(i)), item_at(i));
+        return;
+    }
 
+    std::vector<std::size_t> hashes, order, starts;
+    partition_by_bucket(count, real_size, sizing_mode, thread_number,
+                        [this, &item_at](std::size_t i){ return getHash(item_at(i)); }, hashes, order, starts);
+
+    std::vector<NodePool<ListEl<var_type>>> pools(thread_number);
+    std::vector<int> added(thread_number, 0);
+    std::exception_ptr error;
+    try {
+        parallel_for(thread_number, [&](int t){
+            int own_added = 0;
+            try {
+                for (std::size_t j = starts[t]; j < starts[t + 1]; j++){
+                    std::size_t i = order[j];
+                    LinkedList<var_type>& bucket = element_arr[position_of(hashes[i], real_size)];
+                    if (find_in_bucket(bucket, item_at(i), hashes[i]) != nullptr) continue; // do nothing
+
+                    ListEl<var_type>* new_el = pools[t].create(item_at(i));
+                    if constexpr (should_cache_hash<var_type>::value) new_el -> hash = hashes[i];
+                    bucket.link_front(new_el);
+                    own_added++;
+                }
+            } catch (...) {
+                added[t] = own_added;
+                throw;
             }
+            added[t] = own_added;
+        });
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // the nodes of every thread are linked already, even if another thread failed
+    for (int t = 0; t < thread_number; t++){
+        pool.merge(pools[t]);
+        element_count += added[t];
+    }
+    // the threads did not touch the filter, which is not safe to share
+    if (filter.is_active()) HashSet<var_type, Hash, KeyEqual>::rebuild_filter();
+    if (error) std::rethrow_exception(error);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+template<typename Keep>
+void HashSet<var_type, Hash, KeyEqual>::collect(int threads, std::vector<const var_type*>& out, Keep&& keep) const{
+    int thread_number = thread_count_for(threads, element_count);
+    std::vector<std::vector<const var_type*>> parts(thread_number);
+    parallel_for(thread_number, [&](int t){
+        int from = static_cast<int>((long long)real_size * t / thread_number);
+        int to = static_cast<int>((long long)real_size * (t + 1) / thread_number);
+        for (int i = from; i < to; i++){
+            for (ListEl<var_type>* curr_el = element_arr[i].first_el; curr_el != nullptr; curr_el = curr_el->next_pointer)
+                if (keep(curr_el)) parts[t].push_back(&curr_el->var);
+        }
+    });
+
+    std::size_t total = out.size();
+    for (const std::vector<const var_type*>& part : parts) total += part.size();
+    out.reserve(total);
+    for (const std::vector<const var_type*>& part : parts) out.insert(out.end(), part.begin(), part.end());
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+HashSet<var_type, Hash, KeyEqual> HashSet<var_type, Hash, KeyEqual>::make_empty_like() const{
+    HashSet<var_type, Hash, KeyEqual> result(hasher, key_equal);
+    result.max_load_factor = max_load_factor;
+    result.auto_shrink = auto_shrink;
+    result.update_thresholds();
+    if (sizing_mode != SizingMode::PRIME) result.set_sizing_mode(sizing_mode);
+    if (filter.is_active()) result.set_bloom_filter(true, filter.get_bits_per_key());
+    return result;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::reset_filter(long long bucket_count){
+    if (!filter.is_active()) return;
+    // sized for the most elements the table holds before its next resize
+    filter.resize(static_cast<std::size_t>(bucket_count * max_load_factor) + 1);
+    filter_stale = 0;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::rebuild_filter(){
+    filter.resize(static_cast<std::size_t>(real_size * max_load_factor) + 1);
+    filter_stale = 0;
+    for (int i = 0; i < real_size; i++){
+        for (ListEl<var_type>* curr_el = element_arr[i].first_el; curr_el != nullptr; curr_el = curr_el->next_pointer)
+            filter.insert(node_hash(curr_el));
+    }
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::prefetch_group(const var_type* vars, std::size_t count, std::size_t* hashes,
+                                                       const LinkedList<var_type>** buckets) const{
+    for (std::size_t i = 0; i < count; i++){
+        hashes[i] = getHash(vars[i]);
+        buckets[i] = &element_arr[position_of(hashes[i], real_size)];
+        prefetch(buckets[i]);
+    }
+    // the buckets are on their way, now the heads of the chains
+    for (std::size_t i = 0; i < count; i++) prefetch(buckets[i]->first_el);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::destroy_nodes(){
+    for (int i = 0; i < real_size; i++){
+        ListEl<var_type>* curr_el = element_arr[i].first_el;
+        while (curr_el != nullptr){
+            ListEl<var_type>* next = curr_el->next_pointer;
+            pool.destroy(curr_el);
+            curr_el = next;
+        }
+        element_arr[i].first_el = nullptr;
+        element_arr[i].size = 0;
+    }
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void HashSet<var_type, Hash, KeyEqual>::copy_list(LinkedList<var_type>* new_lst, int new_size){
+    // running through all buckets
+    for (int i = 0; i < real_size; i ++){
+        ListEl<var_type>* curr_el = element_arr[i].first_el;
+        // relinking every node of the chain, elements are already unique
+        while (curr_el != nullptr){
+            ListEl<var_type>* next = curr_el->next_pointer;
+            std::size_t hash = node_hash(curr_el);
+            new_lst[HashSet<var_type, Hash, KeyEqual>::position_of(hash, new_size)].link_front(curr_el);
+            filter.insert(hash);
+            curr_el = next;
         }
+        // the nodes belong to new_lst now, the old list must not delete them
+        element_arr[i].first_el = nullptr;
+        element_arr[i].size = 0;
     }
 }
 
-template<typename var_type>
-long long HashSet<var_type>::next_prime(){
+template<typename var_type, typename Hash, typename KeyEqual>
+long long HashSet<var_type, Hash, KeyEqual>::next_prime(){
     long long min_lim = pow(2, curr_pow_for_primes);
     long long max_lim = pow(2, curr_pow_for_primes+1);
 
     long long middle = (min_lim + max_lim) / 2;
 
     for (long long i = middle; i < max_lim - 1; i++){
-        if (HashSet<var_type>::is_prime(middle - i)){
+        if (HashSet<var_type, Hash, KeyEqual>::is_prime(middle - i)){
             curr_pow_for_primes ++;
             return middle - i;
         }
-        if (HashSet<var_type>::is_prime(middle + i)){
+        if (HashSet<var_type, Hash, KeyEqual>::is_prime(middle + i)){
             curr_pow_for_primes ++;
             return middle + i;
         }
     }
     // if no primes from 2^k-1 to 2^k;
     curr_pow_for_primes ++;
-    return HashSet<var_type>::next_prime();
+    return HashSet<var_type, Hash, KeyEqual>::next_prime();
 }
 
-template<typename var_type>
-bool HashSet<var_type>::is_prime(long long num) {
+template<typename var_type, typename Hash, typename KeyEqual>
+bool HashSet<var_type, Hash, KeyEqual>::is_prime(long long num) {
     if (num < 2) return false;
     if (num == 2 || num == 3) return true;
     if (num % 2 == 0 || num % 3 == 0) return false;
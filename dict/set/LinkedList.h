@@ -4,6 +4,9 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <utility>
+
+#include "../Hashing.h"
 
 #ifndef LEARNING_LINKEDLIST_H
 #define LEARNING_LINKEDLIST_H
@@ -12,13 +15,25 @@
 /**
  * @brief A templated structure representing a node in the linked list.
  *
+ * When should_cache_hash<var_type> holds, the node also keeps the full hash of its value,
+ * which HashSet fills in and uses to skip comparisons and rehashing.
+ *
  * @tparam var_type The type of the value stored in the node.
  */
 template<typename var_type>
-struct ListEl{
-    bool is_empty;                     /**< Flag indicating if the node is empty (actually useless). */
+struct ListEl : HashCache<should_cache_hash<var_type>::value>{
     var_type var;                      /**< The value stored in the node. */
     ListEl<var_type>* next_pointer;    /**< Pointer to the next node in the list. */
+
+    ListEl() = default;
+
+    /**
+     * @brief Constructs a node in place from the arguments of the value.
+     *
+     * @param args Arguments forwarded to the constructor of the value.
+     */
+    template<typename... Args>
+    explicit ListEl(Args&&... args) : var(std::forward<Args>(args)...), next_pointer(nullptr) {}
 };
 
 /**
@@ -214,6 +229,31 @@ protected:
      */
     void find_element_with_var(var_type var, ListEl<var_type>*& previous_element, ListEl<var_type>*& element_to_delete) const;
 
+    /**
+     * @brief Links an existing node in front of the list.
+     *
+     * Used when rehashing: the node is moved as it is, without allocation, copying or a duplicate check.
+     *
+     * @param node The node to link, it must not belong to any list.
+     */
+    void link_front(ListEl<var_type>* node){
+        node->next_pointer = first_el;
+        first_el = node;
+        size++;
+    }
+
+    /**
+     * @brief Unlinks a node from the list without deleting it.
+     *
+     * @param previous_element The node before the one to unlink, nullptr if it is the first one.
+     * @param node The node to unlink.
+     */
+    void unlink(ListEl<var_type>* previous_element, ListEl<var_type>* node){
+        if (previous_element == nullptr) first_el = node->next_pointer;
+        else previous_element->next_pointer = node->next_pointer;
+        size--;
+    }
+
     /**
      * @brief Overloads the insertion operator to print the LinkedList.
      *
@@ -227,7 +267,7 @@ protected:
     }
 
 
-    template <typename T>
+    template <typename T, typename Hash, typename KeyEqual>
     friend class HashSet;
 }; // End of the class
 
@@ -249,7 +289,6 @@ void LinkedList<var_type>::add(var_type var){
     ListEl<var_type>* new_el = new ListEl<var_type>;
     new_el -> var = var;
     new_el -> next_pointer = nullptr;
-    new_el ->is_empty = false;
     if (size == 0){
         first_el = new_el;
     } else {
@@ -273,7 +312,7 @@ bool LinkedList<var_type>::is_in(var_type var){
         ListEl<var_type>* curr_el = first_el;
         // while current element exists
         while (curr_el != nullptr){
-            if (curr_el->var == var && !curr_el->is_empty) return true;
+            if (curr_el->var == var) return true;
             curr_el = curr_el->next_pointer;
         }
         return false;
@@ -332,7 +371,7 @@ void LinkedList<var_type>::find_element_with_var(var_type var, ListEl<var_type>*
     ListEl<var_type>* curr_el = first_el;
 
     while (curr_el != nullptr){
-        if (curr_el->var == var && !curr_el->is_empty){
+        if (curr_el->var == var){
             element_to_delete = curr_el;
             break;
         }
@@ -0,0 +1,119 @@
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../PerfectHash.h"
+
+#ifndef LEARNING_PERFECTHASHSET_H
+#define LEARNING_PERFECTHASHSET_H
+
+
+/**
+ * @brief An immutable set over a minimal perfect hash.
+ *
+ * Built once from a finished HashSet or any range of elements, then only read. The elements
+ * sit in one packed array of exactly n elements, in the order given by a PerfectHash, so
+ * is_in() probes one place and compares one element.
+ *
+ * @tparam var_type The type of elements.
+ * @tparam Hash The hash functor, DefaultHash<var_type> by default.
+ * @tparam KeyEqual The element comparison functor, std::equal_to<var_type> by default.
+ */
+template<typename var_type, typename Hash = DefaultHash<var_type>, typename KeyEqual = std::equal_to<var_type>>
+class PerfectHashSet {
+protected:
+    PerfectHash<var_type, Hash, KeyEqual> function;    /**< Maps every element to its index. */
+    std::vector<var_type> elements;                    /**< The elements, elements[function.index_of(var)] == var. */
+    KeyEqual key_equal;                                /**< The element comparison functor. */
+
+public:
+    /**
+     * @brief Builds the set from a range of elements.
+     *
+     * @param begin The first element.
+     * @param end Past the last element.
+     * @param hash The hash functor to use.
+     * @param equal The element comparison functor to use.
+     * @throws std::logic_error If an element repeats.
+     */
+    template<typename InputIt>
+    PerfectHashSet(InputIt begin, InputIt end, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Builds the set from a HashSet or another container.
+     *
+     * @param set The container, iterated once.
+     * @param hash The hash functor to use.
+     * @param equal The element comparison functor to use.
+     * @throws std::logic_error If an element repeats.
+     */
+    template<typename Container>
+    explicit PerfectHashSet(const Container& set, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : PerfectHashSet(std::begin(set), std::end(set), hash, equal) {}
+
+    /**
+     * @brief Checks if an element is in the PerfectHashSet.
+     *
+     * @param var The element to check for.
+     * @return true If the element is present.
+     * @return false If it is not.
+     */
+    bool is_in(const var_type& var) const {
+        return !elements.empty() && key_equal(elements[function.index_of(var)], var);
+    }
+
+    /**
+     * @brief Retrieves the index of an element in [0, getSize()).
+     *
+     * Every element has its own index, so it can address a side array of per-element data.
+     *
+     * @param var The element.
+     * @return std::size_t The index, or getSize() if the element is absent.
+     */
+    std::size_t index_of(const var_type& var) const {
+        return is_in(var) ? function.index_of(var) : elements.size();
+    }
+
+    /**
+     * @brief Retrieves the number of elements.
+     *
+     * @return std::size_t The count of elements.
+     */
+    [[nodiscard]] std::size_t getSize() const {
+        return elements.size();
+    }
+
+    /**
+     * @brief Retrieves the memory the perfect hash adds on top of the element array.
+     *
+     * @return std::size_t The number of bytes.
+     */
+    [[nodiscard]] std::size_t overhead_size() const {
+        return function.memory_size();
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename var_type, typename Hash, typename KeyEqual>
+template<typename InputIt>
+PerfectHashSet<var_type, Hash, KeyEqual>::PerfectHashSet(InputIt begin, InputIt end, const Hash& hash, const KeyEqual& equal)
+        : function(hash, equal), key_equal(equal) {
+    std::vector<var_type> given;
+    for (; begin != end; ++begin) given.push_back(*begin);
+    function.build(given.size(), [&](std::size_t i) -> const var_type& { return given[i]; });
+
+    // the elements are moved to the indexes the function gives them
+    std::vector<std::size_t> order(given.size());
+    for (std::size_t i = 0; i < given.size(); i++) order[function.index_of(given[i])] = i;
+    elements.reserve(order.size());
+    for (std::size_t i : order) elements.push_back(std::move(given[i]));
+}
+
+#endif //LEARNING_PERFECTHASHSET_H
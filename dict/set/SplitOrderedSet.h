@@ -0,0 +1,450 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "../EpochManager.h"
+#include "../Hashing.h"
+
+#ifndef LEARNING_SPLITORDEREDSET_H
+#define LEARNING_SPLITORDEREDSET_H
+
+
+/**
+ * @brief A node of the SplitOrderedSet list.
+ *
+ * Bucket sentinels are plain SplitListNode objects with an even order key. Elements are
+ * SplitListEl objects with an odd order key. The lowest bit of next_pointer marks the node as
+ * deleted (Harris's marked pointer), so it is a word and not a typed pointer.
+ */
+struct SplitListNode {
+    uint64_t order_key;                   /**< Bit-reversed hash, the list is sorted by it. */
+    std::atomic<uintptr_t> next_pointer;  /**< The next node, with the deletion mark in bit 0. */
+
+    explicit SplitListNode(uint64_t key) : order_key(key), next_pointer(0) {}
+};
+
+/**
+ * @brief An element node of the SplitOrderedSet list.
+ *
+ * @tparam var_type The type of the value stored in the node.
+ */
+template<typename var_type>
+struct SplitListEl : SplitListNode {
+    var_type var;                         /**< The value stored in the node. */
+
+    template<typename V>
+    SplitListEl(uint64_t key, V&& value) : SplitListNode(key), var(std::forward<V>(value)) {}
+};
+
+
+/**
+ * @brief A lock-free hash set based on split-ordered lists (Shalev and Shavit).
+ *
+ * All elements live in one singly linked list, sorted by the bit-reversed hash. With that
+ * order the elements of bucket b (hash mod 2^k) form one contiguous run of the list. When the
+ * table doubles, each bucket is split by inserting one more sentinel node into the list, and no
+ * element ever moves. The bucket array only holds shortcuts to the sentinels. It is made of
+ * segments that are allocated on demand and never reallocated, so growing never pauses anyone.
+ *
+ * add, pop/erase and is_in are lock-free: list updates are single compare-and-swaps, and removal
+ * first marks the node and then unlinks it (Harris and Michael). Unlinked nodes are reclaimed
+ * through an EpochManager, the same one ReadMostlyHashDict uses.
+ *
+ * @tparam var_type The type of elements stored in the SplitOrderedSet.
+ * @tparam Hash The hash functor, DefaultHash<var_type> by default.
+ * @tparam KeyEqual The element comparison functor, std::equal_to<var_type> by default.
+ */
+template<typename var_type, typename Hash = DefaultHash<var_type>, typename KeyEqual = std::equal_to<var_type>>
+class SplitOrderedSet {
+protected:
+    using node_type = SplitListEl<var_type>;
+    using bucket_type = std::atomic<SplitListNode*>;
+
+    static const int FIRST_SEGMENT_BITS = 6;       /**< Segment 0 holds the first 2^6 buckets. */
+    static const int MAX_SEGMENTS = 26;            /**< Segment i > 0 holds 2^(i+5) buckets, 2^31 buckets in total. */
+    static const int MAX_LOAD = 2;                 /**< The table doubles when there are more elements per bucket. */
+
+    mutable std::atomic<bucket_type*> segments[MAX_SEGMENTS];   /**< The bucket segments, allocated on demand. */
+    std::atomic<uint64_t> bucket_count;            /**< The current number of buckets, a power of two. */
+    std::atomic<int> element_count;                /**< The number of elements. */
+    mutable EpochManager epochs;                   /**< Reclaims unlinked nodes. */
+
+    Hash hasher;                                   /**< The hash functor. */
+    KeyEqual key_equal;                            /**< The element comparison functor. */
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Starts with 16 buckets.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The element comparison functor to use.
+     */
+    explicit SplitOrderedSet(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Destructor.
+     *
+     * Must not run while other threads still use the set.
+     */
+    ~SplitOrderedSet();
+
+    SplitOrderedSet(const SplitOrderedSet&) = delete;
+    SplitOrderedSet& operator=(const SplitOrderedSet&) = delete;
+
+    /**
+     * @brief Adds an element to the SplitOrderedSet.
+     *
+     * @param var The element to be added.
+     * @return true If the element was inserted.
+     * @return false If it was already present.
+     */
+    bool add(const var_type& var);
+
+    /**
+     * @brief Removes an element from the SplitOrderedSet.
+     *
+     * @param var The element to be removed.
+     * @throws std::logic_error If the element is not found.
+     */
+    void pop(const var_type& var);
+
+    /**
+     * @brief Removes an element if it is present.
+     *
+     * @param var The element to be removed.
+     * @return true If this call removed the element.
+     * @return false If it was not present.
+     */
+    bool erase(const var_type& var);
+
+    /**
+     * @brief Checks if an element exists in the SplitOrderedSet.
+     *
+     * @param var The element to check for.
+     * @return true If the element is present.
+     * @return false Otherwise.
+     */
+    bool is_in(const var_type& var) const;
+
+    /**
+     * @brief Retrieves the number of elements in the SplitOrderedSet.
+     *
+     * @return int The count of elements.
+     */
+    [[nodiscard]] int getSize() const {
+        return element_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retrieves the current number of buckets.
+     *
+     * @return long long The number of buckets.
+     */
+    [[nodiscard]] long long getTrueSize() const {
+        return static_cast<long long>(bucket_count.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Prints the contents of the SplitOrderedSet in list order.
+     *
+     * @param out The output stream to print to. Defaults to std::cout.
+     */
+    void print(std::ostream& out = std::cout) const;
+
+
+protected:
+    /**
+     * @brief Reverses the bits of a 64-bit value.
+     */
+    static uint64_t reverse_bits(uint64_t x){
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+    }
+
+    /**
+     * @brief The order key of an element: the reversed hash with the lowest bit set.
+     */
+    static uint64_t regular_key(uint64_t hash){
+        return reverse_bits(hash) | 1;
+    }
+
+    /**
+     * @brief The order key of the sentinel of a bucket: the reversed bucket index, lowest bit clear.
+     */
+    static uint64_t sentinel_key(uint64_t bucket){
+        return reverse_bits(bucket);
+    }
+
+    static SplitListNode* pointer_of(uintptr_t word){
+        return reinterpret_cast<SplitListNode*>(word & ~static_cast<uintptr_t>(1));
+    }
+
+    static bool is_marked(uintptr_t word){
+        return (word & 1) != 0;
+    }
+
+    /**
+     * @brief Computes the hash of an element, mixed so that its low bits are good bucket bits.
+     */
+    uint64_t getHash(const var_type& var) const {
+        return mix64(static_cast<uint64_t>(hasher(var)));
+    }
+
+    /**
+     * @brief Finds the bucket slot of a bucket index, allocating its segment if needed.
+     *
+     * @param bucket The bucket index.
+     * @return bucket_type& The slot holding the sentinel of the bucket, nullptr if it is not initialized.
+     */
+    bucket_type& bucket_slot(uint64_t bucket) const;
+
+    /**
+     * @brief Returns the sentinel of a bucket, inserting it (and its parents) into the list if needed.
+     *
+     * @param bucket The bucket index.
+     * @return SplitListNode* The sentinel.
+     */
+    SplitListNode* get_bucket(uint64_t bucket) const;
+
+    /**
+     * @brief Searches the list for a node, starting after the given node.
+     *
+     * Unlinks and retires every marked node it passes. The caller must be pinned.
+     *
+     * @param start The node to start after, a sentinel.
+     * @param key The order key to search for.
+     * @param var The element to search for, nullptr when searching for a sentinel.
+     * @param previous Set to the link that points to current.
+     * @param current Set to the found node, or to the first node after the search position.
+     * @return true If a matching node was found.
+     * @return false Otherwise, a new node belongs between previous and current.
+     */
+    bool list_find(SplitListNode* start, uint64_t key, const var_type* var,
+                   std::atomic<uintptr_t>*& previous, SplitListNode*& current) const;
+
+    /**
+     * @brief Deletes a retired element node.
+     */
+    static void delete_node(void* node){
+        delete static_cast<node_type*>(node);
+    }
+
+    /**
+     * @brief Overloads the insertion operator to print the SplitOrderedSet.
+     *
+     * @param out The output stream.
+     * @param set The SplitOrderedSet to print.
+     * @return std::ostream& The output stream.
+     */
+    friend std::ostream& operator <<(std::ostream& out, const SplitOrderedSet& set){
+        set.print(out);
+        return out;
+    }
+}; // End of the class
+
+
+
+// methods implementation
+
+//public:
+
+template<typename var_type, typename Hash, typename KeyEqual>
+SplitOrderedSet<var_type, Hash, KeyEqual>::SplitOrderedSet(const Hash& hash, const KeyEqual& equal)
+        : bucket_count(16), element_count(0), hasher(hash), key_equal(equal) {
+    for (int i = 0; i < MAX_SEGMENTS; i++) segments[i].store(nullptr, std::memory_order_relaxed);
+    // the sentinel of bucket 0 is the head of the whole list
+    bucket_slot(0).store(new SplitListNode(sentinel_key(0)), std::memory_order_release);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+SplitOrderedSet<var_type, Hash, KeyEqual>::~SplitOrderedSet(){
+    SplitListNode* curr_el = bucket_slot(0).load(std::memory_order_relaxed);
+    while (curr_el != nullptr){
+        SplitListNode* next = pointer_of(curr_el->next_pointer.load(std::memory_order_relaxed));
+        if (curr_el->order_key & 1) delete static_cast<node_type*>(curr_el);
+        else delete curr_el;
+        curr_el = next;
+    }
+    for (int i = 0; i < MAX_SEGMENTS; i++) delete[] segments[i].load(std::memory_order_relaxed);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SplitOrderedSet<var_type, Hash, KeyEqual>::add(const var_type& var){
+    EpochManager::Guard pin = epochs.pin();
+    uint64_t hash = getHash(var);
+    uint64_t key = regular_key(hash);
+    uint64_t buckets = bucket_count.load(std::memory_order_acquire);
+    SplitListNode* sentinel = get_bucket(hash & (buckets - 1));
+
+    node_type* new_el = nullptr;
+    while (true){
+        std::atomic<uintptr_t>* previous;
+        SplitListNode* current;
+        if (list_find(sentinel, key, &var, previous, current)){
+            delete new_el;
+            return false; // do nothing
+        }
+        if (new_el == nullptr) new_el = new node_type(key, var);
+        new_el->next_pointer.store(reinterpret_cast<uintptr_t>(current), std::memory_order_relaxed);
+        uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+        if (previous->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(new_el), std::memory_order_acq_rel)) break;
+    }
+
+    // doubling only changes the bucket count, the new buckets are split lazily
+    int count = element_count.fetch_add(1, std::memory_order_relaxed) + 1;
+    if ((uint64_t)count > buckets * MAX_LOAD && buckets < (1ULL << (FIRST_SEGMENT_BITS + MAX_SEGMENTS - 1)))
+        bucket_count.compare_exchange_strong(buckets, buckets * 2, std::memory_order_acq_rel);
+    return true;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SplitOrderedSet<var_type, Hash, KeyEqual>::pop(const var_type& var){
+    if (!erase(var)) throw std::logic_error("this variable isn't here!!!");
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SplitOrderedSet<var_type, Hash, KeyEqual>::erase(const var_type& var){
+    EpochManager::Guard pin = epochs.pin();
+    uint64_t hash = getHash(var);
+    uint64_t key = regular_key(hash);
+    SplitListNode* sentinel = get_bucket(hash & (bucket_count.load(std::memory_order_acquire) - 1));
+
+    while (true){
+        std::atomic<uintptr_t>* previous;
+        SplitListNode* current;
+        if (!list_find(sentinel, key, &var, previous, current)) return false;
+
+        uintptr_t next = current->next_pointer.load(std::memory_order_acquire);
+        if (is_marked(next)) continue; // another thread is removing it
+        // the mark is the removal itself, whoever sets it owns the element
+        if (!current->next_pointer.compare_exchange_strong(next, next | 1, std::memory_order_acq_rel)) continue;
+
+        uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+        if (previous->compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+            epochs.retire(current, &delete_node);
+        else
+            list_find(sentinel, key, &var, previous, current); // unlinks it on the way
+
+        element_count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SplitOrderedSet<var_type, Hash, KeyEqual>::is_in(const var_type& var) const{
+    EpochManager::Guard pin = epochs.pin();
+    uint64_t hash = getHash(var);
+    SplitListNode* sentinel = get_bucket(hash & (bucket_count.load(std::memory_order_acquire) - 1));
+    std::atomic<uintptr_t>* previous;
+    SplitListNode* current;
+    return list_find(sentinel, regular_key(hash), &var, previous, current);
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SplitOrderedSet<var_type, Hash, KeyEqual>::print(std::ostream& out) const {
+    EpochManager::Guard pin = epochs.pin();
+    SplitListNode* curr_el = bucket_slot(0).load(std::memory_order_acquire);
+    while (curr_el != nullptr){
+        uintptr_t next = curr_el->next_pointer.load(std::memory_order_acquire);
+        if ((curr_el->order_key & 1) && !is_marked(next)) out << static_cast<node_type*>(curr_el)->var << ' ';
+        curr_el = pointer_of(next);
+    }
+}
+
+
+//protected:
+
+template<typename var_type, typename Hash, typename KeyEqual>
+typename SplitOrderedSet<var_type, Hash, KeyEqual>::bucket_type&
+SplitOrderedSet<var_type, Hash, KeyEqual>::bucket_slot(uint64_t bucket) const{
+    int segment = 0;
+    uint64_t offset = bucket;
+    if (bucket >= (1ULL << FIRST_SEGMENT_BITS)){
+        int top_bit = 63;
+        while (!(bucket >> top_bit)) top_bit--;
+        segment = top_bit - FIRST_SEGMENT_BITS + 1;
+        offset = bucket - (1ULL << top_bit);
+    }
+
+    bucket_type* slots = segments[segment].load(std::memory_order_acquire);
+    if (slots == nullptr){
+        std::size_t size = segment == 0 ? (1ULL << FIRST_SEGMENT_BITS) : (1ULL << (segment + FIRST_SEGMENT_BITS - 1));
+        bucket_type* fresh = new bucket_type[size];
+        for (std::size_t i = 0; i < size; i++) fresh[i].store(nullptr, std::memory_order_relaxed);
+        if (segments[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel)) slots = fresh;
+        else delete[] fresh; // another thread was first, slots holds its segment
+    }
+    return slots[offset];
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+SplitListNode* SplitOrderedSet<var_type, Hash, KeyEqual>::get_bucket(uint64_t bucket) const{
+    bucket_type& slot = bucket_slot(bucket);
+    SplitListNode* sentinel = slot.load(std::memory_order_acquire);
+    if (sentinel != nullptr) return sentinel;
+
+    // the parent bucket is the one this bucket was split from
+    uint64_t parent = bucket;
+    int top_bit = 63;
+    while (!(parent >> top_bit)) top_bit--;
+    parent &= ~(1ULL << top_bit);
+    SplitListNode* parent_sentinel = get_bucket(parent);
+
+    uint64_t key = sentinel_key(bucket);
+    SplitListNode* new_sentinel = new SplitListNode(key);
+    while (true){
+        std::atomic<uintptr_t>* previous;
+        SplitListNode* current;
+        if (list_find(parent_sentinel, key, nullptr, previous, current)){
+            // another thread inserted the same sentinel first
+            delete new_sentinel;
+            new_sentinel = current;
+            break;
+        }
+        new_sentinel->next_pointer.store(reinterpret_cast<uintptr_t>(current), std::memory_order_relaxed);
+        uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+        if (previous->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(new_sentinel), std::memory_order_acq_rel)) break;
+    }
+
+    SplitListNode* empty = nullptr;
+    slot.compare_exchange_strong(empty, new_sentinel, std::memory_order_acq_rel);
+    return new_sentinel;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SplitOrderedSet<var_type, Hash, KeyEqual>::list_find(SplitListNode* start, uint64_t key, const var_type* var,
+                                                          std::atomic<uintptr_t>*& previous, SplitListNode*& current) const{
+retry:
+    previous = &start->next_pointer;
+    current = pointer_of(previous->load(std::memory_order_acquire));
+    while (current != nullptr){
+        uintptr_t next = current->next_pointer.load(std::memory_order_acquire);
+        if (is_marked(next)){
+            // helping: unlinking a node that was removed but not unlinked yet
+            uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+            if (!previous->compare_exchange_strong(expected, next & ~static_cast<uintptr_t>(1), std::memory_order_acq_rel)) goto retry;
+            epochs.retire(current, &delete_node);
+            current = pointer_of(next);
+            continue;
+        }
+
+        if (current->order_key > key) return false;
+        if (current->order_key == key){
+            if (var == nullptr) return true; // sentinel keys are unique
+            if (key_equal(static_cast<node_type*>(current)->var, *var)) return true;
+        }
+        previous = &current->next_pointer;
+        current = pointer_of(next);
+    }
+    return false;
+}
+
+#endif //LEARNING_SPLITORDEREDSET_H
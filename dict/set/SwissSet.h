@@ -0,0 +1,477 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+#include "../Hashing.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEARNING_SWISSSET_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifndef LEARNING_SWISSSET_H
+#define LEARNING_SWISSSET_H
+
+
+/**
+ * @brief Control byte values of the SwissSet table.
+ *
+ * A full slot stores the low 7 bits of its hash (0..127), special states are negative.
+ */
+enum SwissCtrl : int8_t {
+    SWISS_EMPTY = -128,   /**< The slot has never been used since the last rehash. */
+    SWISS_DELETED = -2    /**< The slot held an element that was popped (tombstone). */
+};
+
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero mask.
+ */
+inline int swiss_lowest_bit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+
+/**
+ * @brief A group of 8 control bytes matched with plain 64-bit arithmetic.
+ *
+ * This is the SwissGroup of targets without SSE2. It is compiled everywhere so that it can
+ * be checked against the SIMD groups. Every match returns a bitmask in which bit 8*i+7 is
+ * set for a matching slot i of the group.
+ */
+struct SwissGroupPortable {
+    static constexpr int WIDTH = 8;    /**< The number of control bytes in a group. */
+    static constexpr int STRIDE = 8;   /**< The number of mask bits per slot. */
+    uint64_t ctrl;
+
+    static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+    static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+    explicit SwissGroupPortable(const int8_t* pos) {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+    }
+
+    uint64_t match(int8_t h2) const {
+        // may report a false positive next to a real match, keys are compared anyway
+        uint64_t x = ctrl ^ (LSBS * static_cast<uint8_t>(h2));
+        return (x - LSBS) & ~x & MSBS;
+    }
+
+    uint64_t match_empty() const {
+        // 0x80 is the only control byte with bit 7 set and bit 1 clear
+        return ctrl & (~ctrl << 6) & MSBS;
+    }
+
+    uint64_t match_empty_or_deleted() const {
+        return ctrl & MSBS;
+    }
+
+    /**
+     * @brief Returns the index of the lowest matching slot in a non-zero mask.
+     *
+     * @param mask The mask returned by one of the match functions.
+     * @return int The slot index inside the group.
+     */
+    static int lowest(uint64_t mask) {
+        return swiss_lowest_bit(mask) / STRIDE;
+    }
+};
+
+
+#if defined(__AVX2__) || defined(LEARNING_SWISSSET_SSE2)
+/**
+ * @brief A group of control bytes that is matched in one step.
+ *
+ * With AVX2 a group is 32 bytes, with SSE2 it is 16 bytes; without either it is the
+ * 8-byte SwissGroupPortable. Every match returns a bitmask in which bit i is set for
+ * a matching slot i of the group.
+ */
+struct SwissGroup {
+#if defined(__AVX2__)
+    static constexpr int WIDTH = 32;   /**< The number of control bytes in a group. */
+    static constexpr int STRIDE = 1;   /**< The number of mask bits per slot. */
+    __m256i ctrl;
+
+    explicit SwissGroup(const int8_t* pos) : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+    uint32_t match(int8_t h2) const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+    }
+
+    uint32_t match_empty() const {
+        return match(SWISS_EMPTY);
+    }
+
+    uint32_t match_empty_or_deleted() const {
+        // special control bytes are the only negative ones
+        return static_cast<uint32_t>(_mm256_movemask_epi8(ctrl));
+    }
+#else
+    static constexpr int WIDTH = 16;
+    static constexpr int STRIDE = 1;
+    __m128i ctrl;
+
+    explicit SwissGroup(const int8_t* pos) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    uint32_t match(int8_t h2) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    uint32_t match_empty() const {
+        return match(SWISS_EMPTY);
+    }
+
+    uint32_t match_empty_or_deleted() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+#endif
+
+    /**
+     * @brief Returns the index of the lowest matching slot in a non-zero mask.
+     *
+     * @param mask The mask returned by one of the match functions.
+     * @return int The slot index inside the group.
+     */
+    static int lowest(uint64_t mask) {
+        return swiss_lowest_bit(mask);
+    }
+};
+#else
+using SwissGroup = SwissGroupPortable;
+#endif
+
+
+/**
+ * @brief A templated SwissSet class implementing a hash set with SwissTable-style probing.
+ *
+ * Every slot has a 1-byte control tag next to it in a separate array: either the low
+ * 7 bits of the element hash or a special EMPTY/DELETED marker. A lookup compares a whole
+ * group of tags (16 with SSE2, 32 with AVX2) in one step and only compares full elements on
+ * tag matches, so most misses are rejected after one or two group compares without touching
+ * the elements at all.
+ *
+ * The capacity is a power of two and the table is rebuilt when used slots (including
+ * tombstones) exceed 87.5%.
+ *
+ * @tparam var_type The type of elements stored in the SwissSet.
+ * @tparam Hash The hash functor, DefaultHash<var_type> by default.
+ * @tparam KeyEqual The element comparison functor, std::equal_to<var_type> by default.
+ */
+template<typename var_type, typename Hash = DefaultHash<var_type>, typename KeyEqual = std::equal_to<var_type>>
+class SwissSet {
+protected:
+    int real_size;          /**< The current capacity of the table (a power of two). */
+    int element_count;      /**< The number of elements currently in the set. */
+    int deleted_count;      /**< The number of tombstones in the table. */
+
+    int8_t* ctrl;           /**< real_size control bytes followed by a copy of the first group. */
+    var_type* slots;        /**< Array of element slots. */
+
+    Hash hasher;            /**< The hash functor. */
+    KeyEqual key_equal;     /**< The element comparison functor. */
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes the set with the smallest capacity, two groups of empty slots.
+     *
+     * @param hash The hash functor to use.
+     * @param equal The element comparison functor to use.
+     */
+    explicit SwissSet(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    /**
+     * @brief Destructor.
+     *
+     * Cleans up the allocated memory for the table.
+     */
+    ~SwissSet(){
+        delete[] ctrl;
+        delete[] slots;
+    }
+
+    SwissSet(const SwissSet&) = delete;
+    SwissSet& operator=(const SwissSet&) = delete;
+
+    /**
+     * @brief Adds an element to the SwissSet.
+     *
+     * Does nothing if the element is already present.
+     *
+     * @param var The element to be added.
+     */
+    void add(var_type var);
+
+    /**
+     * @brief Checks if an element exists in the SwissSet.
+     *
+     * @param var The element to check for.
+     * @return true If the element is present.
+     * @return false Otherwise.
+     */
+    bool is_in(const var_type& var) const;
+
+    /**
+     * @brief Finds an element of the SwissSet.
+     *
+     * @param var The element to look for.
+     * @return const var_type* Pointer to the stored element, or nullptr if it is not present.
+     */
+    const var_type* find(const var_type& var) const;
+
+    /**
+     * @brief Removes an element if it is present.
+     *
+     * The non-throwing counterpart of pop().
+     *
+     * @param var The element to be removed.
+     * @return true If the element was found and removed.
+     * @return false If the element was not present.
+     */
+    bool erase(const var_type& var);
+
+    /**
+     * @brief Removes an element from the SwissSet.
+     *
+     * @param var The element to be removed.
+     * @throws std::logic_error If the element is not found.
+     */
+    void pop(const var_type& var);
+
+    /**
+     * @brief Retrieves the number of elements in the SwissSet.
+     *
+     * @return int The count of elements.
+     */
+    [[nodiscard]] int getSize() const {
+        return element_count;
+    }
+
+    /**
+     * @brief Retrieves the current capacity of the table.
+     *
+     * @return int The number of slots.
+     */
+    [[nodiscard]] int getTrueSize() const {
+        return real_size;
+    }
+
+    /**
+     * @brief Prints the contents of the SwissSet.
+     *
+     * @param out The output stream to print to. Defaults to std::cout.
+     */
+    void print(std::ostream& out = std::cout) const;
+
+
+protected:
+
+    /**
+     * @brief Finds the slot holding the given element.
+     *
+     * @param var The element to search for.
+     * @param hash The mixed hash of the element.
+     * @return int The slot index, or -1 if the element is not present.
+     */
+    int find_index(const var_type& var, uint64_t hash) const;
+
+    /**
+     * @brief Finds the first empty or deleted slot on the probe sequence of a hash.
+     *
+     * @param hash The mixed hash of the element.
+     * @return int The slot index.
+     */
+    int find_free_slot(uint64_t hash) const;
+
+    /**
+     * @brief Writes a control byte, keeping the cloned first group in sync.
+     *
+     * @param index The slot index.
+     * @param tag The new control byte.
+     */
+    void set_ctrl(int index, int8_t tag){
+        ctrl[index] = tag;
+        if (index < SwissGroup::WIDTH) ctrl[real_size + index] = tag;
+    }
+
+    /**
+     * @brief Rebuilds the table with the given capacity, dropping all tombstones.
+     *
+     * @param new_size The new capacity, a power of two and at least one group.
+     */
+    void rehash(int new_size);
+
+    /**
+     * @brief Computes the mixed 64-bit hash of an element.
+     *
+     * The low 7 bits become the control tag (H2) and the rest selects the start group (H1).
+     * The Hash result is mixed once more, so that user hashes with weak low bits still
+     * produce useful tags.
+     *
+     * @param var The element to hash.
+     * @return uint64_t The mixed hash.
+     */
+    uint64_t mixed_hash(const var_type& var) const {
+        return mix64(static_cast<uint64_t>(hasher(var)));
+    }
+
+    /**
+     * @brief Overloads the insertion operator to print the SwissSet.
+     *
+     * @param out The output stream.
+     * @param set The SwissSet to print.
+     * @return std::ostream& The output stream.
+     */
+    friend std::ostream& operator <<(std::ostream& out, const SwissSet& set){
+        set.print(out);
+        return out;
+    }
+}; // End of the class
+
+// methods implementation
+
+template<typename var_type, typename Hash, typename KeyEqual>
+SwissSet<var_type, Hash, KeyEqual>::SwissSet(const Hash& hash, const KeyEqual& equal) : hasher(hash), key_equal(equal) {
+    real_size = 2 * SwissGroup::WIDTH;
+    element_count = 0;
+    deleted_count = 0;
+    ctrl = new int8_t[real_size + SwissGroup::WIDTH];
+    std::memset(ctrl, SWISS_EMPTY, real_size + SwissGroup::WIDTH);
+    slots = new var_type[real_size];
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SwissSet<var_type, Hash, KeyEqual>::add(var_type var){
+    uint64_t hash = mixed_hash(var);
+    if (find_index(var, hash) != -1) return;
+
+    // tombstones take probe length just like elements, so both count towards the limit
+    if ((long long)(element_count + deleted_count + 1) * 8 > (long long)real_size * 7){
+        // mostly tombstones: rebuilding at the same size is enough
+        if ((long long)element_count * 2 < real_size) rehash(real_size);
+        else rehash(real_size * 2);
+    }
+
+    int position = find_free_slot(hash);
+    if (ctrl[position] == SWISS_DELETED) deleted_count--;
+    slots[position] = std::move(var);
+    set_ctrl(position, static_cast<int8_t>(hash & 0x7F));
+    element_count++;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SwissSet<var_type, Hash, KeyEqual>::is_in(const var_type& var) const{
+    return find_index(var, mixed_hash(var)) != -1;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+const var_type* SwissSet<var_type, Hash, KeyEqual>::find(const var_type& var) const{
+    int position = find_index(var, mixed_hash(var));
+    return position == -1 ? nullptr : &slots[position];
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SwissSet<var_type, Hash, KeyEqual>::pop(const var_type& var){
+    if (!erase(var)) throw std::logic_error("this variable isn't here!!!");
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+bool SwissSet<var_type, Hash, KeyEqual>::erase(const var_type& var){
+    int position = find_index(var, mixed_hash(var));
+    if (position == -1) return false;
+
+    slots[position] = var_type();
+    set_ctrl(position, SWISS_DELETED);
+    element_count--;
+    deleted_count++;
+    return true;
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SwissSet<var_type, Hash, KeyEqual>::print(std::ostream& out) const {
+    for (int i = 0; i < real_size; i++){
+        if (ctrl[i] < 0) continue;
+        out << slots[i] << ' ';
+    }
+}
+
+
+//protected
+
+template<typename var_type, typename Hash, typename KeyEqual>
+int SwissSet<var_type, Hash, KeyEqual>::find_index(const var_type& var, uint64_t hash) const {
+    int mask = real_size - 1;
+    int8_t h2 = static_cast<int8_t>(hash & 0x7F);
+    int position = static_cast<int>(hash >> 7) & mask;
+    int step = 0;
+
+    // triangular probing over groups visits every group once because real_size is a power of two
+    while (true){
+        SwissGroup group(ctrl + position);
+        for (auto matches = group.match(h2); matches != 0; matches &= matches - 1){
+            int index = (position + SwissGroup::lowest(matches)) & mask;
+            if (key_equal(slots[index], var)) return index;
+        }
+        if (group.match_empty()) return -1;
+        step += SwissGroup::WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+int SwissSet<var_type, Hash, KeyEqual>::find_free_slot(uint64_t hash) const {
+    int mask = real_size - 1;
+    int position = static_cast<int>(hash >> 7) & mask;
+    int step = 0;
+
+    while (true){
+        auto free = SwissGroup(ctrl + position).match_empty_or_deleted();
+        if (free) return (position + SwissGroup::lowest(free)) & mask;
+        step += SwissGroup::WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+template<typename var_type, typename Hash, typename KeyEqual>
+void SwissSet<var_type, Hash, KeyEqual>::rehash(int new_size){
+    int8_t* old_ctrl = ctrl;
+    var_type* old_slots = slots;
+    int old_size = real_size;
+
+    real_size = new_size;
+    deleted_count = 0;
+    ctrl = new int8_t[real_size + SwissGroup::WIDTH];
+    std::memset(ctrl, SWISS_EMPTY, real_size + SwissGroup::WIDTH);
+    slots = new var_type[real_size];
+
+    for (int i = 0; i < old_size; i++){
+        if (old_ctrl[i] < 0) continue;
+        uint64_t hash = mixed_hash(old_slots[i]);
+        int position = find_free_slot(hash);
+        slots[position] = std::move(old_slots[i]);
+        set_ctrl(position, static_cast<int8_t>(hash & 0x7F));
+    }
+
+    delete[] old_ctrl;
+    delete[] old_slots;
+}
+
+
+#endif //LEARNING_SWISSSET_H
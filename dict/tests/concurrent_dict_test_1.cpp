@@ -0,0 +1,128 @@
+#include "../ConcurrentHashDict.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cctype>
+
+// Тест для паралельного додавання з кількох потоків
+TEST(ConcurrentHashDictTest, ParallelAdd) {
+    ConcurrentHashDict<int, int> dict;
+    const int threadCount = 8;
+    const int perThread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&dict, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                dict.add(t * perThread + i, i);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    ASSERT_EQ(dict.getSize(), threadCount * perThread);
+    for (int key = 0; key < threadCount * perThread; ++key) {
+        ASSERT_EQ(dict.try_get(key), key % perThread);
+    }
+}
+
+// Тест для одночасних читачів і письменників
+TEST(ConcurrentHashDictTest, ReadersAndWriters) {
+    ConcurrentHashDict<std::string, int> dict(16);
+    const int dataSize = 10000;
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("stable_" + std::to_string(i), i);
+    }
+
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        // Читачі: стабільні ключі завжди на місці
+        threads.emplace_back([&dict, &failed]() {
+            for (int round = 0; round < 3; ++round) {
+                for (int i = 0; i < dataSize; ++i) {
+                    std::optional<int> value = dict.try_get("stable_" + std::to_string(i));
+                    if (!value || *value != i) failed = true;
+                }
+            }
+        });
+        // Письменники: додають і видаляють власні ключі
+        threads.emplace_back([&dict, t]() {
+            for (int i = 0; i < dataSize; ++i) {
+                std::string key = "temp_" + std::to_string(t) + "_" + std::to_string(i);
+                dict.add(key, i);
+                dict.update(key, [](int& value) { value++; });
+                if (i % 2 == 0) dict.pop(key);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(dict.getSize(), dataSize + 4 * dataSize / 2);
+    EXPECT_EQ(dict.try_get("temp_1_7"), 8);
+    EXPECT_FALSE(dict.is_in("temp_1_8"));
+    EXPECT_FALSE(dict.erase("temp_1_8"));
+
+    long long total = 0;
+    dict.for_each([&total](const std::string& key, const int& value) {
+        if (key.rfind("stable_", 0) == 0) total += value;
+    });
+    EXPECT_EQ(total, (long long)dataSize * (dataSize - 1) / 2);
+}
+
+// Тест для лічильника, що оновлюється з багатьох потоків
+TEST(ConcurrentHashDictTest, AtomicUpdate) {
+    ConcurrentHashDict<int, long long> counters(4);
+    counters.reserve(100);
+    for (int i = 0; i < 10; ++i) counters.add(i, 0LL);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counters]() {
+            for (int i = 0; i < 10000; ++i) counters.update(i % 10, [](long long& value) { value++; });
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(counters.try_get(i), 8000);
+    }
+    EXPECT_THROW((ConcurrentHashDict<int, int>(0)), std::logic_error);
+}
+
+// Функтори без урахування регістру, які мають дійти до кожного сегмента
+struct CaseInsensitiveHash {
+    std::size_t operator()(const std::string& s) const {
+        std::string lower = s;
+        for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return DefaultHash<std::string>()(lower);
+    }
+};
+
+struct CaseInsensitiveEqual {
+    bool operator()(const std::string& a, const std::string& b) const {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+        }
+        return true;
+    }
+};
+
+// Тест для власних Hash і KeyEqual у сегментах
+TEST(ConcurrentHashDictTest, CustomFunctors) {
+    ConcurrentHashDict<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> dict(8, CaseInsensitiveHash(), CaseInsensitiveEqual());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(dict.add("Key_" + std::to_string(i), i));
+    }
+    EXPECT_FALSE(dict.add("KEY_5", -5)); // той самий ключ в іншому регістрі
+    EXPECT_EQ(dict.try_get("key_5"), 5);
+    EXPECT_TRUE(dict.erase("kEy_7"));
+    EXPECT_EQ(dict.getSize(), 999);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
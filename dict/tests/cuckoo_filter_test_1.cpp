@@ -0,0 +1,83 @@
+#include "../set/CuckooFilter.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// Тест для додавання, перевірки та видалення
+TEST(CuckooFilterTest, AddIsInPop) {
+    const int dataSize = 100000;
+    CuckooFilter<std::string> filter(dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        ASSERT_TRUE(filter.add("key_" + std::to_string(i)));
+    }
+    EXPECT_EQ(filter.getSize(), (size_t)dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        ASSERT_TRUE(filter.is_in("key_" + std::to_string(i))); // без хибних відмов
+    }
+
+    for (int i = 0; i < dataSize; i += 2) {
+        filter.pop("key_" + std::to_string(i));
+    }
+    EXPECT_EQ(filter.getSize(), (size_t)dataSize / 2);
+    for (int i = 1; i < dataSize; i += 2) {
+        ASSERT_TRUE(filter.is_in("key_" + std::to_string(i))); // решта на місці
+    }
+    EXPECT_FALSE(filter.erase("never_added"));
+    EXPECT_THROW(filter.pop("never_added"), std::logic_error);
+
+    // Дублікати зберігаються окремими копіями
+    filter.add("twice");
+    filter.add("twice");
+    filter.pop("twice");
+    EXPECT_TRUE(filter.is_in("twice"));
+    filter.pop("twice");
+    EXPECT_FALSE(filter.is_in("twice"));
+}
+
+// Тест для частки хибних спрацьовувань при різній ширині відбитка
+TEST(CuckooFilterTest, FalsePositiveRate) {
+    const int dataSize = 200000;
+    const int probes = 1000000;
+
+    CuckooFilter<int, uint8_t> small(dataSize);
+    CuckooFilter<int, uint16_t> large(dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        small.add(i);
+        large.add(i);
+    }
+    double smallRate = CuckooFilter<int, uint8_t>::false_positive_rate();
+    double largeRate = CuckooFilter<int, uint16_t>::false_positive_rate();
+    int smallHits = 0, largeHits = 0;
+    for (int i = dataSize; i < dataSize + probes; ++i) {
+        smallHits += small.is_in(i);
+        largeHits += large.is_in(i);
+    }
+    EXPECT_LT(smallHits, probes * 2 * smallRate);
+    EXPECT_LT(largeHits, probes * 2 * largeRate + 20);
+    EXPECT_LT(large.memory_size(), (size_t)dataSize * 4); // не більше 4 байтів на елемент
+}
+
+// Тест для заповнення до межі
+TEST(CuckooFilterTest, FillUntilFull) {
+    CuckooFilter<int, uint16_t> filter(1000);
+    int added = 0;
+    while (filter.add(added)) ++added;
+    EXPECT_GE(added, 1000);
+    EXPECT_LE((size_t)added, filter.getTrueSize());
+    // Елемент, що заповнив фільтр, збережено, а наступні вже ні
+    EXPECT_EQ(filter.getSize(), (size_t)added + 1);
+    EXPECT_FALSE(filter.add(-2));
+    EXPECT_EQ(filter.getSize(), (size_t)added + 1);
+    for (int i = 0; i <= added; ++i) {
+        ASSERT_TRUE(filter.is_in(i)); // навіть останній витіснений відбиток знаходиться
+    }
+    // Після видалення знову є місце
+    for (int i = 0; i <= added; ++i) filter.pop(i);
+    EXPECT_EQ(filter.getSize(), 0u);
+    EXPECT_TRUE(filter.add(-1));
+    EXPECT_TRUE(filter.is_in(-1));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,679 @@
+#include "../HashDict.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Лічильник виділень пам'яті для тестів малого режиму
+static std::atomic<long> allocations{0};
+static std::atomic<long> allocated_bytes{0};
+static std::atomic<long> fail_allocation{-1}; // номер виділення, що кидає std::bad_alloc, -1 — жодне
+
+void* operator new(std::size_t size) {
+    if (allocations++ == fail_allocation) throw std::bad_alloc();
+    allocated_bytes += static_cast<long>(size);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// Складений ключ з власною хеш-функцією
+struct Point {
+    int x;
+    int y;
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+};
+
+struct PointHash {
+    std::size_t operator()(const Point& p) const {
+        return hash_combine(DefaultHash<int>()(p.x), DefaultHash<int>()(p.y));
+    }
+};
+
+// Тест для власних Hash і KeyEqual
+TEST(HashDictHashingTest, CustomStructKeys) {
+    HashDict<Point, int, PointHash> dict;
+    for (int x = 0; x < 300; ++x) {
+        for (int y = 0; y < 300; ++y) {
+            dict.add(Point{x, y}, x * 1000 + y);
+        }
+    }
+    ASSERT_EQ(dict.getSize(), 300 * 300);
+    EXPECT_EQ(dict[(Point{12, 34})], 12034);
+    EXPECT_FALSE(dict.is_in(Point{300, 0}));
+
+    // Порівняння рядків без урахування регістру
+    struct CaseInsensitiveHash {
+        std::size_t operator()(const std::string& s) const {
+            std::string lower = s;
+            for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return DefaultHash<std::string>()(lower);
+        }
+    };
+    struct CaseInsensitiveEqual {
+        bool operator()(const std::string& a, const std::string& b) const {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+            }
+            return true;
+        }
+    };
+    HashDict<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> words;
+    words.add("Apple", 1);
+    words.add("APPLE", 2); // той самий ключ
+    EXPECT_EQ(words.getSize(), 1);
+    EXPECT_EQ(words["apple"], 1);
+
+    // -0.0 і 0.0 - один і той самий ключ
+    HashDict<double, int> doubles;
+    doubles.add(0.0, 1);
+    EXPECT_TRUE(doubles.is_in(-0.0));
+}
+
+// Тест для поступового перехешування: ключі доступні під час міграції
+TEST(HashDictRehashTest, IncrementalRehash) {
+    HashDict<std::string, int> dict;
+    dict.set_incremental_rehash(true);
+    const int dataSize = 100000;
+    bool seen_migration = false;
+
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("key_" + std::to_string(i), i);
+        if (dict.is_rehashing()) {
+            seen_migration = true;
+            // Перевірка ключів, доданих до і після початку міграції
+            EXPECT_TRUE(dict.is_in("key_0"));
+            EXPECT_TRUE(dict.is_in("key_" + std::to_string(i)));
+        }
+    }
+    EXPECT_TRUE(seen_migration);
+    ASSERT_EQ(dict.getSize(), dataSize);
+
+    // Видалення кожного другого елемента
+    for (int i = 0; i < dataSize; i += 2) {
+        dict.pop("key_" + std::to_string(i));
+    }
+    ASSERT_EQ(dict.getSize(), dataSize / 2);
+
+    for (int i = 0; i < dataSize; ++i) {
+        if (i % 2 == 0) {
+            EXPECT_FALSE(dict.is_in("key_" + std::to_string(i)));
+        } else {
+            EXPECT_EQ(dict["key_" + std::to_string(i)], i);
+        }
+    }
+
+    dict.set_incremental_rehash(false);
+    EXPECT_FALSE(dict.is_rehashing());
+}
+
+// Тест для розмірів-степенів двійки замість простих чисел
+TEST(HashDictRehashTest, PowerOfTwoSizing) {
+    HashDict<int, int> dict;
+    for (int i = 0; i < 1000; ++i) {
+        dict.add(i, i);
+    }
+    dict.set_sizing_mode(SizingMode::POWER_OF_TWO);
+    EXPECT_EQ(dict.getTrueSize() & (dict.getTrueSize() - 1), 0);
+
+    const int dataSize = 100000;
+    for (int i = 1000; i < dataSize; ++i) {
+        dict.add(i, i);
+    }
+    ASSERT_EQ(dict.getSize(), dataSize);
+    EXPECT_EQ(dict.getTrueSize() & (dict.getTrueSize() - 1), 0);
+
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_EQ(dict[i], i);
+    }
+    EXPECT_FALSE(dict.is_in(-5));
+
+    dict.set_sizing_mode(SizingMode::PRIME);
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_EQ(dict[i], i);
+    }
+}
+
+// Тест для пошуку без винятків: find, try_get, erase
+TEST(HashDictLookupTest, FindTryGetErase) {
+    HashDict<std::string, int> dict;
+    dict.set_incremental_rehash(true);
+    const int dataSize = 50000;
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("key_" + std::to_string(i), i);
+    }
+
+    int* value = dict.find("key_42");
+    ASSERT_NE(value, nullptr);
+    *value = -42; // зміна значення через вказівник
+    EXPECT_EQ(dict["key_42"], -42);
+    EXPECT_EQ(dict.find("missing"), nullptr);
+
+    const HashDict<std::string, int>& const_dict = dict;
+    ASSERT_NE(const_dict.find("key_7"), nullptr);
+    EXPECT_EQ(*const_dict.find("key_7"), 7);
+    EXPECT_EQ(const_dict.try_get("key_8"), 8);
+    EXPECT_FALSE(const_dict.try_get("missing").has_value());
+
+    EXPECT_TRUE(dict.erase("key_8"));
+    EXPECT_FALSE(dict.erase("key_8")); // повторне видалення не кидає виняток
+    EXPECT_EQ(dict.getSize(), dataSize - 1);
+    EXPECT_THROW(dict.pop("key_8"), std::logic_error);
+}
+
+// Значення, що рахує свої копіювання
+struct CopyCounter {
+    static int copies;
+    std::vector<int> data;
+    CopyCounter() = default;
+    CopyCounter(int size, int fill) : data(size, fill) {}
+    CopyCounter(const CopyCounter& other) : data(other.data) { ++copies; }
+    CopyCounter(CopyCounter&&) = default;
+    CopyCounter& operator=(const CopyCounter& other) { data = other.data; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter&&) = default;
+};
+int CopyCounter::copies = 0;
+
+// Тест для переміщення, emplace, try_emplace та insert_or_assign
+TEST(HashDictLookupTest, MoveAndEmplace) {
+    HashDict<std::string, CopyCounter> dict;
+    CopyCounter::copies = 0;
+    for (int i = 0; i < 10000; ++i) {
+        dict.add("key_" + std::to_string(i), CopyCounter(4, i)); // тимчасові значення переміщуються
+    }
+    auto inserted = dict.emplace("big", 1000, 7); // значення будується прямо у вузлі
+    EXPECT_TRUE(inserted.second);
+    EXPECT_EQ(inserted.first->data.size(), 1000u);
+
+    auto existing = dict.try_emplace(std::string("big"), 5, 5);
+    EXPECT_FALSE(existing.second);
+    EXPECT_EQ(existing.first, inserted.first);
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    auto assigned = dict.insert_or_assign("key_3", CopyCounter(2, -1));
+    EXPECT_FALSE(assigned.second);
+    EXPECT_EQ(dict["key_3"].data, std::vector<int>({-1, -1}));
+    EXPECT_TRUE(dict.insert_or_assign("new", CopyCounter()).second);
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    const CopyCounter lvalue(1, 1);
+    dict.add("copy", lvalue); // лише одне копіювання
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(dict.getSize(), 10003);
+
+    // Значення, яке не можна копіювати
+    HashDict<int, std::unique_ptr<int>> owners;
+    owners.add(1, std::make_unique<int>(10));
+    owners.try_emplace(2, new int(20));
+    EXPECT_EQ(*owners[1], 10);
+    EXPECT_EQ(*owners[2], 20);
+}
+
+// Тест для пулу вузлів: повторне використання звільнених вузлів
+TEST(HashDictPoolTest, ChurnReusesNodes) {
+    HashDict<std::string, std::string> dict;
+    const int dataSize = 20000;
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < dataSize; ++i) {
+            dict.add("key_" + std::to_string(i), std::string(40, 'a' + round));
+        }
+        ASSERT_EQ(dict.getSize(), dataSize);
+        EXPECT_EQ(dict["key_17"], std::string(40, 'a' + round));
+        for (int i = 0; i < dataSize; ++i) {
+            ASSERT_TRUE(dict.erase("key_" + std::to_string(i)));
+        }
+        ASSERT_EQ(dict.getSize(), 0);
+    }
+
+    NodePool<ListEl<int, int>> pool;
+    ListEl<int, int>* first = pool.create(1, 2);
+    pool.destroy(first);
+    ListEl<int, int>* second = pool.create(3, 4);
+    EXPECT_EQ(first, second); // звільнений вузол використано знову
+    EXPECT_EQ(second->value, 4);
+    pool.destroy(second);
+}
+
+// Тест для reserve, shrink_to_fit та коефіцієнта заповнення
+TEST(HashDictRehashTest, ReserveAndShrink) {
+    HashDict<int, int> dict;
+    const int dataSize = 100000;
+    dict.reserve(dataSize);
+    const int reserved = dict.getTrueSize();
+    EXPECT_GE(reserved * dict.get_max_load_factor(), dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add(i, i);
+    }
+    EXPECT_EQ(dict.getTrueSize(), reserved); // жодного перехешування під час завантаження
+
+    for (int i = 0; i < dataSize - 100; ++i) {
+        dict.pop(i);
+    }
+    EXPECT_EQ(dict.getTrueSize(), reserved); // без auto_shrink таблиця не зменшується
+    dict.shrink_to_fit();
+    EXPECT_LT(dict.getTrueSize(), 1000);
+    EXPECT_LE(dict.load_factor(), dict.get_max_load_factor());
+    for (int i = dataSize - 100; i < dataSize; ++i) {
+        EXPECT_EQ(dict[i], i);
+    }
+
+    // Більший коефіцієнт заповнення - менше кошиків
+    dict.set_max_load_factor(4.0f);
+    dict.shrink_to_fit();
+    EXPECT_LT(dict.getTrueSize(), 100);
+    EXPECT_THROW(dict.set_max_load_factor(0), std::logic_error);
+
+    // Автоматичне зменшення
+    HashDict<int, int> sparse;
+    sparse.set_auto_shrink(true);
+    for (int i = 0; i < dataSize; ++i) {
+        sparse.add(i, i);
+    }
+    const int full_size = sparse.getTrueSize();
+    for (int i = 0; i < dataSize - 10; ++i) {
+        sparse.pop(i);
+    }
+    EXPECT_LT(sparse.getTrueSize(), full_size / 100);
+    for (int i = dataSize - 10; i < dataSize; ++i) {
+        EXPECT_EQ(sparse[i], i);
+    }
+}
+
+// Тест для ітераторів, зокрема під час поступового перехешування
+TEST(HashDictIteratorTest, RangeFor) {
+    HashDict<std::string, long long> dict;
+    dict.set_incremental_rehash(true);
+    EXPECT_TRUE(dict.begin() == dict.end());
+
+    const int dataSize = 30000;
+    long long expected = 0;
+    bool checked_migration = false;
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("key_" + std::to_string(i), i);
+        expected += i;
+        if (dict.is_rehashing() && !checked_migration) {
+            checked_migration = true;
+            int count = 0;
+            for (auto entry : dict) {
+                (void)entry;
+                ++count;
+            }
+            EXPECT_EQ(count, dict.getSize()); // жоден елемент не пропущено
+        }
+    }
+    EXPECT_TRUE(checked_migration);
+
+    long long total = 0;
+    int count = 0;
+    for (auto [key, value] : dict) {
+        EXPECT_EQ(key, "key_" + std::to_string(value));
+        total += value;
+        value *= 2; // зміна значення через ітератор
+        ++count;
+    }
+    EXPECT_EQ(count, dataSize);
+    EXPECT_EQ(total, expected);
+    EXPECT_EQ(dict["key_21"], 42);
+
+    const HashDict<std::string, long long>& const_dict = dict;
+    long long doubled = 0;
+    for (auto it = const_dict.begin(); it != const_dict.end(); it++) {
+        doubled += it->value;
+    }
+    EXPECT_EQ(doubled, expected * 2);
+    HashDict<std::string, long long>::const_iterator converted = dict.begin();
+    EXPECT_TRUE(converted == const_dict.begin());
+}
+
+// Тест для пакетних операцій з попередньою вибіркою
+TEST(HashDictBatchTest, ManyKeys) {
+    HashDict<int, int> dict;
+    const int dataSize = 100003; // не кратне розміру групи
+    std::vector<int> keys(dataSize), values(dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        keys[i] = i * 3;
+        values[i] = i;
+    }
+    dict.add_many(keys.data(), values.data(), keys.size());
+    ASSERT_EQ(dict.getSize(), dataSize);
+
+    std::vector<int> queries(2 * dataSize);
+    for (int i = 0; i < 2 * dataSize; ++i) queries[i] = i;
+    std::unique_ptr<bool[]> found(new bool[queries.size()]);
+    dict.contains_many(queries.data(), queries.size(), found.get());
+    std::vector<int*> pointers(queries.size());
+    dict.find_many(queries.data(), queries.size(), pointers.data());
+    for (int i = 0; i < 2 * dataSize; ++i) {
+        ASSERT_EQ(found[i], i % 3 == 0 && i / 3 < dataSize);
+        if (found[i]) {
+            ASSERT_NE(pointers[i], nullptr);
+            EXPECT_EQ(*pointers[i], i / 3);
+        } else {
+            EXPECT_EQ(pointers[i], nullptr);
+        }
+    }
+
+    // Під час поступового перехешування
+    HashDict<std::string, int> strings;
+    strings.set_incremental_rehash(true);
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; ++i) names.push_back("name_" + std::to_string(i));
+    for (int i = 0; i < 2500; ++i) strings.add(names[i], i);
+    std::vector<int> numbers(names.size(), 7);
+    strings.add_many(names.data(), numbers.data(), names.size());
+    ASSERT_EQ(strings.getSize(), 5000);
+    const HashDict<std::string, int>& const_strings = strings;
+    std::vector<const int*> results(names.size());
+    const_strings.find_many(names.data(), names.size(), results.data());
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_NE(results[i], nullptr);
+        EXPECT_EQ(*results[i], i < 2500 ? i : 7);
+    }
+}
+
+// Тест для паралельної побудови зі списку пар
+TEST(HashDictBatchTest, BuildParallel) {
+    const int dataSize = 200000;
+    std::vector<std::pair<std::string, int>> rows;
+    for (int i = 0; i < dataSize; ++i) rows.emplace_back("key_" + std::to_string(i), i);
+    rows.emplace_back("key_7", -1); // дублікат, перший виграє
+
+    HashDict<std::string, int> dict;
+    dict.add("key_3", 300); // уже наявний ключ не змінюється
+    dict.build_parallel(rows.begin(), rows.end(), 4);
+    ASSERT_EQ(dict.getSize(), dataSize);
+    EXPECT_LE(dict.load_factor(), dict.get_max_load_factor());
+    EXPECT_EQ(dict["key_3"], 300);
+    EXPECT_EQ(dict["key_7"], 7);
+    for (int i = 0; i < dataSize; i += 97) {
+        ASSERT_EQ(dict["key_" + std::to_string(i)], i == 3 ? 300 : i);
+    }
+
+    // Вузли з пулів потоків працюють як звичайні
+    for (int i = 0; i < dataSize; i += 2) dict.pop("key_" + std::to_string(i));
+    EXPECT_EQ(dict.getSize(), dataSize / 2);
+    dict.add("extra", 1);
+    EXPECT_TRUE(dict.is_in("extra"));
+
+    // Малий діапазон у режимі степенів двійки
+    HashDict<int, int> small;
+    small.set_sizing_mode(SizingMode::POWER_OF_TWO);
+    std::vector<std::pair<int, int>> pairs = {{1, 10}, {2, 20}, {3, 30}};
+    small.build_parallel(pairs.begin(), pairs.end());
+    EXPECT_EQ(small.getSize(), 3);
+    EXPECT_EQ(small[2], 20);
+}
+
+// Маленьке значення, що рахує живі екземпляри
+struct Counted {
+    static int alive;
+    int value;
+    explicit Counted(int v = 0) : value(v) { ++alive; }
+    Counted(const Counted& other) noexcept : value(other.value) { ++alive; }
+    Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+    Counted& operator=(const Counted& other) = default;
+    ~Counted() { --alive; }
+};
+int Counted::alive = 0;
+
+// Тест для першого елемента кошика, що зберігається прямо в масиві
+TEST(HashDictPoolTest, InlineFirstEntry) {
+    EXPECT_TRUE((should_inline_first<int, int>::value));
+    EXPECT_TRUE((should_inline_first<int, Counted>::value));
+    EXPECT_FALSE((should_inline_first<std::string, std::string>::value)); // завеликий вузол
+
+    const int dataSize = 100000;
+    for (bool incremental : {false, true}) {
+        {
+            HashDict<int, Counted> dict;
+            dict.set_incremental_rehash(incremental);
+            dict.set_auto_shrink(true);
+            for (int i = 0; i < dataSize; ++i) {
+                dict.emplace(i, i * 2);
+            }
+            for (int i = 0; i < dataSize; i += 3) {
+                ASSERT_TRUE(dict.erase(i)); // видалення і першого, і наступних у ланцюжку
+            }
+            for (int i = 0; i < dataSize; ++i) {
+                const Counted* value = dict.find(i);
+                if (i % 3 == 0) {
+                    ASSERT_EQ(value, nullptr);
+                } else {
+                    ASSERT_NE(value, nullptr);
+                    ASSERT_EQ(value->value, i * 2);
+                }
+            }
+            for (int i = 0; i < dataSize; i += 3) dict.emplace(i, -i);
+
+            int visited = 0;
+            for (auto [key, value] : dict) {
+                EXPECT_EQ(value.value, key % 3 == 0 ? -key : key * 2);
+                ++visited;
+            }
+            EXPECT_EQ(visited, dataSize);
+            EXPECT_EQ(Counted::alive, dataSize);
+
+            for (int i = 0; i < dataSize; ++i) dict.pop(i); // зі стисканням таблиці
+            EXPECT_EQ(dict.getSize(), 0);
+            EXPECT_EQ(Counted::alive, 0);
+            dict.add(1, Counted(5));
+        }
+        EXPECT_EQ(Counted::alive, 0); // деструктор знищує і вбудовані елементи
+    }
+}
+
+// Хеш, що залишає ключ як є: при простих розмірах номер кошика - це остача від ділення
+struct IdentityHash {
+    std::size_t operator()(int key) const { return static_cast<std::size_t>(key); }
+};
+
+// Тест для резерву вузлів міграції: вставки під час поступової міграції його не забирають
+TEST(HashDictPoolTest, MigrationKeepsReservedNodes) {
+    {
+        HashDict<int, Counted, IdentityHash> dict;
+        dict.set_incremental_rehash(true);
+        // 0, 53, 106 і 159 займають окремі кошики з 23, але один кошик з 53,
+        // тож міграції потрібні 3 вузли пулу
+        std::vector<int> keys = {0, 53, 106, 159, 2, 3, 4, 5, 6, 1};
+        for (int key : keys) dict.emplace(key, key);
+        EXPECT_EQ(dict.getTrueSize(), 23);
+        // Ланцюжок у кошику 1 залишає пулу 3 вільні вузли, яких якраз вистачає на резерв
+        for (int key : {24, 47, 70}) dict.emplace(key, key);
+        for (int key : {24, 47, 70}) ASSERT_TRUE(dict.erase(key));
+        for (int key = 8; !dict.is_rehashing(); ++key) {
+            if (key % 23 == 14 || key % 23 == 21) continue; // без ланцюжків
+            dict.emplace(key, key);
+            keys.push_back(key);
+        }
+        EXPECT_EQ(dict.getTrueSize(), 53);
+
+        // Вставки під час міграції (і та, що її почала) беруть вузли пулу, але не зарезервовані
+        dict.emplace(1000, 1000);
+        keys.push_back(1000);
+        // Пошук теж переносить кошики, тому решта міграції йде, коли кожне виділення пам'яті кидає std::bad_alloc
+        while (dict.is_rehashing()) {
+            bool found = false;
+            fail_allocation = allocations.load();
+            ASSERT_NO_THROW(found = dict.is_in(0));
+            fail_allocation = -1;
+            EXPECT_TRUE(found);
+        }
+        EXPECT_EQ(Counted::alive, static_cast<int>(keys.size()));
+        for (int key : keys) ASSERT_EQ(dict[key].value, key);
+    }
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+// Тест для малого режиму без масиву кошиків
+TEST(HashDictPoolTest, SmallMode) {
+    for (bool incremental : {false, true}) {
+        HashDict<int, Counted> dict;
+        dict.set_incremental_rehash(incremental);
+        EXPECT_EQ(dict.getTrueSize(), 1); // лише вбудований кошик
+        int limit = small_dict_capacity<int, Counted>::value;
+        EXPECT_EQ(limit, 8);
+        for (int i = 0; i < limit; ++i) dict.emplace(i, i);
+        EXPECT_EQ(dict.getTrueSize(), 1);
+        dict.reserve(limit);
+        dict.shrink_to_fit();
+        dict.set_sizing_mode(SizingMode::POWER_OF_TWO);
+        EXPECT_EQ(dict.getTrueSize(), 1);
+
+        // Видалення з середини, початку і кінця масиву: останній елемент займає дірку
+        for (int key : {3, 0, limit - 1}) {
+            ASSERT_TRUE(dict.erase(key));
+            EXPECT_FALSE(dict.is_in(key));
+            EXPECT_FALSE(dict.erase(key));
+        }
+        EXPECT_EQ(dict.getSize(), limit - 3);
+        for (int key : {limit - 1, 0, 3}) dict.emplace(key, key);
+        EXPECT_EQ(dict.getTrueSize(), 1);
+        EXPECT_EQ(Counted::alive, limit);
+        for (int i = 0; i < limit; ++i) ASSERT_EQ(dict[i].value, i);
+        EXPECT_FALSE(dict.is_in(limit));
+
+        int sum = 0, visited = 0;
+        for (auto [key, value] : dict) {
+            EXPECT_EQ(value.value, key);
+            sum += key;
+            ++visited;
+        }
+        EXPECT_EQ(visited, limit);
+        EXPECT_EQ(sum, limit * (limit - 1) / 2);
+
+        // Перехід до хеш-таблиці
+        for (int i = limit; i < 1000; ++i) dict.emplace(i, i);
+        EXPECT_GT(dict.getTrueSize(), 1);
+        for (int i = 0; i < 1000; ++i) ASSERT_EQ(dict[i].value, i);
+        EXPECT_EQ(Counted::alive, 1000);
+    }
+    EXPECT_EQ(Counted::alive, 0);
+
+    // Рядки: великий вузол, але в об'єкті все одно вміщаються 4 елементи
+    HashDict<std::string, std::string> names;
+    EXPECT_EQ((small_dict_capacity<std::string, std::string>::value), 4);
+    names.add("a", "1");
+    names.add("b", "2");
+    names.add("c", "3");
+    names.add("d", "4");
+    EXPECT_EQ(names.getTrueSize(), 1);
+    ASSERT_TRUE(names.erase("a"));
+    names.add("a", "5");
+    EXPECT_EQ(names.getTrueSize(), 1);
+    names.add("e", "6");
+    EXPECT_GT(names.getTrueSize(), 1);
+    EXPECT_EQ(names["a"], "5");
+    EXPECT_EQ(names["d"], "4");
+    EXPECT_EQ(names["e"], "6");
+
+    // Типи, що не переміщуються, не мають малого режиму: перший елемент створює масив кошиків
+    EXPECT_EQ((small_dict_capacity<int, std::atomic<int>>::value), 0);
+    HashDict<int, std::atomic<int>> counters;
+    EXPECT_EQ(counters.getTrueSize(), 1);
+    counters.emplace(0, 0);
+    EXPECT_GT(counters.getTrueSize(), 1);
+    for (int i = 1; i < 100; ++i) counters.emplace(i, i);
+    ++*counters.find(7);
+    EXPECT_EQ(counters[7].load(), 8);
+}
+
+// Хеш, що рахує свої виклики
+struct CountingHash {
+    static inline int calls = 0;
+    std::size_t operator()(const std::string& key) const {
+        ++calls;
+        return DefaultHash<std::string>()(key);
+    }
+};
+
+// Тест для розміру об'єкта і виділень пам'яті в малому режимі
+TEST(HashDictPoolTest, SmallModeFootprint) {
+    // Об'єкт - це масив вузлів малого режиму і не більше 64 байтів службових полів,
+    // для 8 цілих ключів це менше, ніж раніше займали 5 елементів (1000 байтів)
+    EXPECT_LE(sizeof(HashDict<int, int>), 8 * 24u + 64);
+    EXPECT_LE(sizeof(HashDict<std::string, int>), 4 * 56u + 64 + 16);
+    EXPECT_LE(sizeof(HashDict<std::string, std::string>), 4 * 80u + 64 + 16);
+
+    long before = allocations;
+    {
+        HashDict<int, int> dict;
+        int limit = small_dict_capacity<int, int>::value;
+        for (int i = 0; i < limit; ++i) dict.add(i, i);
+        EXPECT_EQ(dict[limit - 1], limit - 1);
+        HashDict<std::string, int> words;
+        for (const char* word : {"one", "two", "three", "four"}) words.add(word, 1);
+        EXPECT_FALSE(words.is_in("five"));
+        EXPECT_EQ(allocations - before, 0); // жодного виділення
+    }
+
+    // Малий режим не хешує ключі, хеші з'являються лише під час переходу
+    HashDict<std::string, int, CountingHash> hashed;
+    for (int i = 0; i < 4; ++i) hashed.add("key_" + std::to_string(i), i);
+    EXPECT_TRUE(hashed.is_in("key_2"));
+    EXPECT_FALSE(hashed.is_in("key_9"));
+    EXPECT_TRUE(hashed.erase("key_0"));
+    EXPECT_EQ(CountingHash::calls, 0);
+    for (int i = 4; i < 100; ++i) hashed.add("key_" + std::to_string(i), i);
+    for (int i = 1; i < 100; ++i) ASSERT_EQ(hashed["key_" + std::to_string(i)], i);
+
+    // Невдале виділення під час виходу з малого режиму нічого не змінює
+    int fits = small_dict_capacity<int, Counted>::value;
+    for (long failing = 0; ; ++failing) {
+        {
+            HashDict<int, Counted> dict;
+            for (int i = 0; i < fits; ++i) dict.emplace(i, i);
+            bool thrown = false;
+            fail_allocation = allocations + failing;
+            try {
+                dict.emplace(fits, fits);
+            } catch (const std::bad_alloc&) {
+                thrown = true;
+            }
+            fail_allocation = -1;
+            for (int i = 0; i < fits; ++i) ASSERT_EQ(dict[i].value, i);
+            EXPECT_EQ(dict.is_in(fits), !thrown);
+            EXPECT_EQ(Counted::alive, thrown ? fits : fits + 1);
+            if (!thrown) break;
+        }
+        EXPECT_EQ(Counted::alive, 0);
+    }
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+// Тест для розміру пулу вузлів у малих словниках
+TEST(HashDictPoolTest, SmallPoolFootprint) {
+    using Node = ListEl<int, std::atomic<int>>;
+    // Пул займає не більше ніж удвічі більше за свої вузли і заголовки блоків
+    for (int n = 1; n <= 8; ++n) {
+        long bytes = allocated_bytes, chunks = allocations;
+        NodePool<Node> pool;
+        Node* nodes[8];
+        for (int i = 0; i < n; ++i) nodes[i] = pool.create(i, i);
+        bytes = allocated_bytes - bytes;
+        chunks = allocations - chunks;
+        EXPECT_LE(chunks, 4);
+        EXPECT_LE(bytes, static_cast<long>((2 * n - 1) * sizeof(Node) + 16 * chunks)) << n;
+        for (int i = 0; i < n; ++i) pool.destroy(nodes[i]);
+    }
+
+    // Словник без малого режиму: усе, крім масиву кошиків, - вузли з невеликим запасом
+    for (int n = 1; n <= 8; ++n) {
+        long bytes = allocated_bytes;
+        HashDict<int, std::atomic<int>> dict;
+        for (int i = 0; i < n; ++i) dict.emplace(i, i);
+        long buckets = static_cast<long>(dict.getTrueSize() * sizeof(LinkedList_dict<int, std::atomic<int>>)) + 16;
+        EXPECT_LE(allocated_bytes - bytes - buckets, static_cast<long>(2 * n * sizeof(Node) + 8 * 16)) << n;
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
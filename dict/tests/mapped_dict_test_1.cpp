@@ -0,0 +1,120 @@
+#include "../HashDict.h"
+#include "../MappedHashDict.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Тест для читання замороженого словника з пам'яті
+TEST(MappedHashDictTest, FreezeIntToDouble) {
+    const int dataSize = 100000;
+    HashDict<int, double> dict;
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add(i, i * 0.5);
+    }
+    std::string image = dict.freeze();
+
+    MappedHashDict<int, double> mapped(image.data(), image.size());
+    EXPECT_EQ(mapped.getSize(), (size_t)dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        const double* value = mapped.find(i);
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, i * 0.5);
+    }
+    for (int i = dataSize; i < 2 * dataSize; ++i) {
+        ASSERT_FALSE(mapped.is_in(i)); // відсутні ключі
+    }
+
+    // Порожній словник теж заморожується
+    HashDict<int, double> empty;
+    std::string emptyImage = empty.freeze();
+    MappedHashDict<int, double> mappedEmpty(emptyImage.data(), emptyImage.size());
+    EXPECT_EQ(mappedEmpty.getSize(), 0u);
+    EXPECT_FALSE(mappedEmpty.is_in(0));
+}
+
+// Тест для збереження у файл і відображення через mmap
+TEST(MappedHashDictTest, SaveAndMapStrings) {
+    const int dataSize = 50000;
+    const std::string path = "/tmp/mapped_dict_test_1.frozen";
+    {
+        HashDict<std::string, std::string> dict;
+        dict.set_incremental_rehash(true); // частина кошиків ще в старому масиві
+        for (int i = 0; i < dataSize; ++i) {
+            dict.add("key_" + std::to_string(i), "value_" + std::to_string(i * 3));
+        }
+        dict.save(path);
+    }
+
+    MappedHashDict<std::string, std::string> mapped(path);
+    EXPECT_EQ(mapped.getSize(), (size_t)dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        auto value = mapped.find("key_" + std::to_string(i));
+        ASSERT_TRUE(value.has_value());
+        ASSERT_EQ(*value, "value_" + std::to_string(i * 3));
+    }
+    EXPECT_FALSE(mapped.find("key_").has_value());
+    EXPECT_FALSE(mapped.is_in("key_" + std::to_string(dataSize)));
+    std::remove(path.c_str());
+}
+
+// Тест для пошкоджених і чужих файлів
+TEST(MappedHashDictTest, InvalidImages) {
+    HashDict<int, int> dict;
+    for (int i = 0; i < 1000; ++i) dict.add(i, i);
+    std::string image = dict.freeze();
+
+    // Інші типи
+    EXPECT_THROW((MappedHashDict<int, double>(image.data(), image.size())), std::logic_error);
+    EXPECT_THROW((MappedHashDict<std::string, int>(image.data(), image.size())), std::logic_error);
+    EXPECT_THROW((MappedHashDict<int, float>(image.data(), image.size())), std::logic_error); // той самий розмір
+    EXPECT_THROW((MappedHashDict<unsigned, int>(image.data(), image.size())), std::logic_error);
+
+    // Обрізаний образ
+    std::string cut = image.substr(0, image.size() / 2);
+    EXPECT_THROW((MappedHashDict<int, int>(cut.data(), cut.size())), std::logic_error);
+
+    // Зіпсований заголовок
+    std::string broken = image;
+    broken[0] = 'X';
+    EXPECT_THROW((MappedHashDict<int, int>(broken.data(), broken.size())), std::logic_error);
+
+    // Зсув, що переповнюється при додаванні
+    std::string overflow = image;
+    FrozenHeader header;
+    std::memcpy(&header, overflow.data(), sizeof(header));
+    header.offsets_offset = ~0ULL - 7;
+    std::memcpy(&overflow[0], &header, sizeof(header));
+    EXPECT_THROW((MappedHashDict<int, int>(overflow.data(), overflow.size())), std::logic_error);
+
+    // Рядок за межами образу
+    HashDict<std::string, std::string> names;
+    names.add("key", "value");
+    const std::string strings = names.freeze();
+    std::memcpy(&header, strings.data(), sizeof(header));
+    EXPECT_NO_THROW((MappedHashDict<std::string, std::string>(strings.data(), strings.size())));
+    std::string badKey = strings;
+    FrozenString far{~0ULL - 2, 5}; // offset + length переповнюється
+    std::memcpy(&badKey[header.entries_offset + sizeof(uint64_t)], &far, sizeof(far));
+    EXPECT_THROW((MappedHashDict<std::string, std::string>(badKey.data(), badKey.size())), std::logic_error);
+    std::string badValue = strings;
+    far = FrozenString{0, header.file_size}; // довший за весь рядковий блок
+    std::memcpy(&badValue[header.entries_offset + sizeof(uint64_t) + sizeof(FrozenString)], &far, sizeof(far));
+    EXPECT_THROW((MappedHashDict<std::string, std::string>(badValue.data(), badValue.size())), std::logic_error);
+
+    // Не той файл
+    const std::string path = "/tmp/mapped_dict_test_1.txt";
+    {
+        std::ofstream out(path);
+        out << "definitely not a frozen dict, but long enough to hold a header of one";
+    }
+    EXPECT_THROW((MappedHashDict<int, int>(path)), std::logic_error);
+    std::remove(path.c_str());
+    EXPECT_THROW((MappedHashDict<int, int>("/tmp/no_such_dir/no_such_file")), std::logic_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+#include "../HashDict.h"
+#include "../PerfectHashDict.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Тест для того, що функція бієктивна і компактна
+TEST(PerfectHashTest, MinimalAndCompact) {
+    const int dataSize = 1000000;
+    PerfectHash<int> function;
+    function.build(dataSize, [](std::size_t i) { return static_cast<int>(i * 7 + 3); });
+    EXPECT_EQ(function.getSize(), (size_t)dataSize);
+
+    std::vector<bool> seen(dataSize, false);
+    for (int i = 0; i < dataSize; ++i) {
+        std::size_t index = function.index_of(i * 7 + 3);
+        ASSERT_LT(index, (size_t)dataSize);
+        ASSERT_FALSE(seen[index]); // без колізій
+        seen[index] = true;
+    }
+    EXPECT_LT(function.memory_size() * 8.0 / dataSize, 5.0); // менше 5 бітів на ключ
+
+    // Дублікат залишає порожню функцію, а не напівпобудовану
+    EXPECT_THROW(function.build(100, [](std::size_t i) { return static_cast<int>(i % 99); }), std::logic_error);
+    EXPECT_EQ(function.getSize(), 0u);
+    EXPECT_EQ(function.index_of(5), 0u);
+    EXPECT_EQ(function.memory_size(), 0u);
+
+    // Маленькі набори теж будуються
+    for (int count = 0; count < 20; ++count) {
+        PerfectHash<int> small;
+        small.build(count, [](std::size_t i) { return static_cast<int>(i); });
+        std::vector<bool> used(count, false);
+        for (int i = 0; i < count; ++i) {
+            std::size_t index = small.index_of(i);
+            ASSERT_LT(index, (size_t)count);
+            ASSERT_FALSE(used[index]);
+            used[index] = true;
+        }
+    }
+}
+
+// Тест для побудови з готового HashDict
+TEST(PerfectHashTest, DictFromHashDict) {
+    const int dataSize = 100000;
+    HashDict<std::string, int> dict;
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("key_" + std::to_string(i), i);
+    }
+
+    PerfectHashDict<std::string, int> frozen(dict);
+    EXPECT_EQ(frozen.getSize(), (size_t)dataSize);
+    for (int i = 0; i < dataSize; ++i) {
+        const int* value = frozen.find("key_" + std::to_string(i));
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, i);
+    }
+    for (int i = dataSize; i < 2 * dataSize; ++i) {
+        ASSERT_FALSE(frozen.is_in("key_" + std::to_string(i))); // відсутні ключі
+    }
+    EXPECT_THROW(frozen["missing"], std::logic_error);
+
+    // Значення можна змінювати на місці
+    *frozen.find("key_5") = -5;
+    EXPECT_EQ(frozen["key_5"], -5);
+}
+
+// Тест для побудови з діапазону пар і дублікатів
+TEST(PerfectHashTest, DictFromRange) {
+    std::vector<std::pair<int, double>> pairs;
+    for (int i = 0; i < 10000; ++i) pairs.emplace_back(i * i, i * 0.25);
+
+    PerfectHashDict<int, double> frozen(pairs.begin(), pairs.end());
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_EQ(frozen[i * i], i * 0.25);
+    }
+    EXPECT_FALSE(frozen.is_in(2));
+
+    PerfectHashDict<int, double> empty(std::vector<std::pair<int, double>>{});
+    EXPECT_EQ(empty.getSize(), 0u);
+    EXPECT_EQ(empty.find(0), nullptr);
+
+    pairs.emplace_back(4, 1.0); // ключ 4 = 2 * 2 уже є
+    EXPECT_THROW((PerfectHashDict<int, double>(pairs)), std::logic_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
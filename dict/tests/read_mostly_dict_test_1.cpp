@@ -0,0 +1,104 @@
+#include "../ReadMostlyHashDict.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+// Тест для основних операцій в одному потоці
+TEST(ReadMostlyHashDictTest, SingleThread) {
+    ReadMostlyHashDict<std::string, int> dict;
+    const int dataSize = 20000;
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_TRUE(dict.add("key_" + std::to_string(i), i));
+    }
+    EXPECT_FALSE(dict.add("key_5", 100)); // ключ уже є
+    ASSERT_EQ(dict.getSize(), dataSize);
+    EXPECT_GE(dict.getTrueSize() * 3, dataSize * 4 - 4);
+
+    int value = -1;
+    EXPECT_TRUE(dict.find("key_5", value));
+    EXPECT_EQ(value, 5);
+    EXPECT_FALSE(dict.try_get("missing").has_value());
+
+    EXPECT_FALSE(dict.insert_or_assign("key_5", 500));
+    EXPECT_EQ(dict.try_get("key_5"), 500);
+    EXPECT_TRUE(dict.insert_or_assign("new_key", 1));
+
+    for (int i = 0; i < dataSize; i += 2) {
+        dict.pop("key_" + std::to_string(i));
+    }
+    EXPECT_THROW(dict.pop("key_0"), std::logic_error);
+    EXPECT_EQ(dict.getSize(), dataSize / 2 + 1);
+    for (int i = 1; i < dataSize; i += 2) {
+        ASSERT_TRUE(dict.read("key_" + std::to_string(i), [i](const int& v) { EXPECT_EQ(v, i == 5 ? 500 : i); }));
+    }
+}
+
+// Тест для читачів без блокувань під час змін і перехешування
+TEST(ReadMostlyHashDictTest, ReadersDuringWrites) {
+    ReadMostlyHashDict<int, std::string> dict;
+    const int stableSize = 5000;
+    for (int i = 0; i < stableSize; ++i) {
+        dict.add(i, std::to_string(i));
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                for (int i = 0; i < stableSize; i += 7) {
+                    std::optional<std::string> value = dict.try_get(i);
+                    // значення або старе, або нове, але ніколи не зіпсоване
+                    if (!value || (*value != std::to_string(i) && *value != "v" + std::to_string(i))) failed = true;
+                }
+            }
+        });
+    }
+
+    // Письменник: нові ключі (з перехешуванням), заміна і видалення
+    for (int i = stableSize; i < 20 * stableSize; ++i) {
+        dict.add(i, "temp");
+        if (i % 3 == 0) dict.erase(i);
+    }
+    for (int i = 0; i < stableSize; ++i) {
+        dict.insert_or_assign(i, "v" + std::to_string(i));
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(dict.try_get(10), "v10");
+}
+
+// Тест для двох письменників, що одночасно вставляють той самий відсутній ключ
+TEST(ReadMostlyHashDictTest, InsertOrAssignRacesAdd) {
+    ReadMostlyHashDict<int, int> dict;
+    const int keyCount = 200000;
+    std::vector<char> added(keyCount), inserted(keyCount);
+    std::atomic<bool> start(false);
+
+    std::thread adder([&]() {
+        while (!start) {}
+        for (int i = 0; i < keyCount; ++i) added[i] = dict.add(i, -1);
+    });
+    std::thread assigner([&]() {
+        while (!start) {}
+        for (int i = 0; i < keyCount; ++i) inserted[i] = dict.insert_or_assign(i, i);
+    });
+    start = true;
+    adder.join();
+    assigner.join();
+
+    for (int i = 0; i < keyCount; ++i) {
+        ASSERT_EQ(dict.try_get(i), i); // insert_or_assign завжди лишає своє значення
+        ASSERT_NE(added[i], inserted[i]); // вставив рівно один із письменників
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
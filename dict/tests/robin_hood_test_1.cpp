@@ -0,0 +1,147 @@
+#include "../RobinHoodDict.h"
+#include <gtest/gtest.h>
+#include <new>
+#include <string>
+
+// Тест для базових операцій з цілочисельними ключами
+TEST(RobinHoodDictTest, AddIntKeys) {
+    RobinHoodDict<int, std::string> dict;
+    dict.add(1, "one");
+    dict.add(2, "two");
+    dict.add(3, "three");
+    dict.add(3, "three again"); // повторний ключ ігнорується
+
+    ASSERT_EQ(dict.getSize(), 3);
+    EXPECT_EQ(dict[1], "one");
+    EXPECT_EQ(dict[2], "two");
+    EXPECT_EQ(dict[3], "three");
+    EXPECT_THROW(dict[4], std::logic_error);
+}
+
+// Тест для великих даних з рядковими ключами та збільшенням таблиці
+TEST(RobinHoodDictTest, LargeStringKeys) {
+    RobinHoodDict<std::string, int> dict;
+    const int dataSize = 200000;
+
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add("key_" + std::to_string(i), i);
+    }
+    ASSERT_EQ(dict.getSize(), dataSize);
+
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_EQ(dict["key_" + std::to_string(i)], i);
+    }
+    EXPECT_FALSE(dict.is_in("key_" + std::to_string(dataSize)));
+}
+
+// Тест для видалення зі зсувом назад: решта ключів мають залишитися доступними
+TEST(RobinHoodDictTest, BackwardShiftPop) {
+    RobinHoodDict<int, int> dict;
+    const int dataSize = 100000;
+
+    for (int i = 0; i < dataSize; ++i) {
+        dict.add(i, i * 2);
+    }
+
+    // Видалення кожного третього елемента
+    for (int i = 0; i < dataSize; i += 3) {
+        dict.pop(i);
+    }
+    ASSERT_EQ(dict.getSize(), dataSize - (dataSize + 2) / 3);
+
+    for (int i = 0; i < dataSize; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_FALSE(dict.is_in(i));
+        } else {
+            EXPECT_EQ(dict[i], i * 2);
+        }
+    }
+    EXPECT_THROW(dict.pop(0), std::logic_error);
+}
+
+// Тест для find, try_get та erase
+TEST(RobinHoodDictTest, FindTryGetErase) {
+    RobinHoodDict<int, int> dict;
+    for (int i = 0; i < 1000; ++i) {
+        dict.add(i, i * 2);
+    }
+    ASSERT_NE(dict.find(10), nullptr);
+    EXPECT_EQ(*dict.find(10), 20);
+    EXPECT_EQ(dict.find(1000), nullptr);
+    EXPECT_EQ(dict.try_get(11), 22);
+    EXPECT_FALSE(dict.try_get(-1).has_value());
+
+    EXPECT_TRUE(dict.erase(10));
+    EXPECT_FALSE(dict.erase(10));
+    EXPECT_EQ(dict.getSize(), 999);
+}
+
+// Хеш, що рахує свої виклики і дає багато колізій
+struct CountingHash {
+    static inline int calls = 0;
+    std::size_t operator()(int key) const {
+        ++calls;
+        return static_cast<std::size_t>(key % 4);
+    }
+};
+
+// Тест для того, що add хешує ключ один раз і правильно зсуває довгі ланцюжки
+TEST(RobinHoodDictTest, AddHashesOnce) {
+    RobinHoodDict<int, int, CountingHash> dict;
+    for (int i = 0; i < 6; ++i) {
+        dict.add(i, i);
+    }
+    CountingHash::calls = 0;
+    dict.add(3, 100); // ключ уже є
+    dict.add(-1, -1); // 7 з 8 слотів, без розширення
+    EXPECT_EQ(CountingHash::calls, 2);
+    EXPECT_EQ(dict[3], 3);
+
+    for (int i = 6; i < 300; ++i) {
+        dict.add(i, i);
+        dict.add(i / 2, -1); // уже є
+    }
+    EXPECT_EQ(dict.getSize(), 301);
+    for (int i = -1; i < 300; ++i) {
+        ASSERT_EQ(dict[i], i);
+    }
+}
+
+// Значення, чий конструктор за замовчуванням можна змусити кинути виняток
+struct FragileValue {
+    static inline bool fail = false;
+    int value = 0;
+    FragileValue() {
+        if (fail) throw std::bad_alloc();
+    }
+    FragileValue(int v) : value(v) {}
+};
+
+// Тест для того, що невдале розширення не псує словник
+TEST(RobinHoodDictTest, GrowFailureKeepsTable) {
+    RobinHoodDict<int, FragileValue> dict;
+    for (int i = 0; i < 7; ++i) {
+        dict.add(i, FragileValue(i));
+    }
+    const int size = dict.getTrueSize();
+
+    FragileValue::fail = true;
+    EXPECT_THROW(dict.add(7, FragileValue(7)), std::bad_alloc); // восьмий елемент розширює таблицю
+    FragileValue::fail = false;
+
+    EXPECT_EQ(dict.getTrueSize(), size);
+    EXPECT_EQ(dict.getSize(), 7);
+    EXPECT_FALSE(dict.is_in(7));
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_EQ(dict[i].value, i);
+    }
+    dict.add(7, FragileValue(7));
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(dict[i].value, i);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,9 +1,13 @@
 // Created by Volodymyr Avvakumov on 05.11.2024.
 #include "../set/HashSet.h"
 #include "../set/LinkedList.h"
+#include "../set/PerfectHashSet.h"
 #include <gtest/gtest.h>
 #include <string>
 #include <cmath>
+#include <vector>
+#include <memory>
+#include <type_traits>
 
 // Тест для додавання елементів та перевірки наявності у множині
 TEST(HashSetLargeDataTest, AddAndIsInTest) {
@@ -112,6 +116,248 @@ TEST(HashSetLargeDataTest, PopNonExistentElement) {
     EXPECT_THROW(set.pop(10), std::logic_error);
 }
 
+// Тест для розмірів-степенів двійки замість простих чисел
+TEST(HashSetLargeDataTest, PowerOfTwoSizing) {
+    HashSet<std::string> set;
+    set.set_sizing_mode(SizingMode::POWER_OF_TWO);
+    const int dataSize = 20000;
+
+    for (int i = 0; i < dataSize; ++i) {
+        set.add("key_" + std::to_string(i));
+    }
+    ASSERT_EQ(set.getSize(), dataSize);
+
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_TRUE(set.is_in("key_" + std::to_string(i)));
+    }
+    EXPECT_FALSE(set.is_in("absent"));
+}
+
+// Тест для пошуку та видалення без винятків
+TEST(HashSetLargeDataTest, FindAndErase) {
+    HashSet<std::string> set;
+    for (int i = 0; i < 1000; ++i) {
+        set.add("item_" + std::to_string(i));
+    }
+    const std::string* found = set.find("item_5");
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(*found, "item_5");
+    EXPECT_EQ(set.find("item_1000"), nullptr);
+
+    EXPECT_TRUE(set.erase("item_5"));
+    EXPECT_FALSE(set.erase("item_5"));
+    EXPECT_EQ(set.getSize(), 999);
+}
+
+// Тест для reserve та shrink_to_fit
+TEST(HashSetLargeDataTest, ReserveAndShrink) {
+    HashSet<int> set;
+    const int dataSize = 50000;
+    set.reserve(dataSize);
+    const int reserved = set.getTrueSize();
+    for (int i = 0; i < dataSize; ++i) {
+        set.add(i);
+    }
+    EXPECT_EQ(set.getTrueSize(), reserved);
+
+    set.set_auto_shrink(true);
+    for (int i = 0; i < dataSize - 10; ++i) {
+        set.pop(i);
+    }
+    EXPECT_LT(set.getTrueSize(), reserved / 100);
+    for (int i = dataSize - 10; i < dataSize; ++i) {
+        EXPECT_TRUE(set.is_in(i));
+    }
+    set.shrink_to_fit();
+    EXPECT_LE(set.load_factor(), set.get_max_load_factor());
+}
+
+// Тест для ітератора множини
+TEST(HashSetLargeDataTest, RangeFor) {
+    HashSet<int> set;
+    EXPECT_TRUE(set.begin() == set.end());
+    const int dataSize = 10000;
+    for (int i = 0; i < dataSize; ++i) {
+        set.add(i);
+    }
+    long long total = 0;
+    int count = 0;
+    for (const int& value : set) {
+        total += value;
+        ++count;
+    }
+    EXPECT_EQ(count, dataSize);
+    EXPECT_EQ(total, (long long)dataSize * (dataSize - 1) / 2);
+}
+
+// Тест для пакетних операцій
+TEST(HashSetLargeDataTest, ManyElements) {
+    HashSet<std::string> set;
+    std::vector<std::string> items;
+    for (int i = 0; i < 20000; ++i) items.push_back("item_" + std::to_string(i));
+    set.add_many(items.data(), items.size() / 2);
+    ASSERT_EQ(set.getSize(), 10000);
+
+    std::unique_ptr<bool[]> found(new bool[items.size()]);
+    set.contains_many(items.data(), items.size(), found.get());
+    std::vector<const std::string*> pointers(items.size());
+    set.find_many(items.data(), items.size(), pointers.data());
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(found[i], i < 10000);
+        if (i < 10000) {
+            ASSERT_NE(pointers[i], nullptr);
+            EXPECT_EQ(*pointers[i], items[i]);
+        } else {
+            EXPECT_EQ(pointers[i], nullptr);
+        }
+    }
+}
+
+// Тест для паралельної побудови
+TEST(HashSetLargeDataTest, BuildParallel) {
+    const int dataSize = 200000;
+    std::vector<int> items;
+    for (int i = 0; i < dataSize; ++i) items.push_back(i * 2);
+    for (int i = 0; i < 1000; ++i) items.push_back(i * 2); // дублікати
+
+    HashSet<int> set;
+    set.build_parallel(items.begin(), items.end(), 3);
+    ASSERT_EQ(set.getSize(), dataSize);
+    for (int i = 0; i < 2 * dataSize; ++i) {
+        ASSERT_EQ(set.is_in(i), i % 2 == 0);
+    }
+    set.pop(0);
+    EXPECT_FALSE(set.is_in(0));
+}
+
+// Тест для операцій над множинами
+TEST(HashSetLargeDataTest, SetAlgebra) {
+    for (int threads : {1, 4}) {
+        HashSet<int> a, b;
+        for (int i = 0; i < 30000; ++i) a.add(i);          // [0, 30000)
+        for (int i = 20000; i < 25000; ++i) b.add(i);      // менша множина всередині a
+        for (int i = 40000; i < 41000; ++i) b.add(i);      // і трохи поза a
+
+        HashSet<int> both = a.intersect(b, threads);
+        EXPECT_EQ(both.getSize(), 5000);
+        EXPECT_TRUE(both.is_in(20000));
+        EXPECT_FALSE(both.is_in(40000));
+
+        HashSet<int> all = a.union_with(b, threads);
+        EXPECT_EQ(all.getSize(), 31000);
+        EXPECT_TRUE(all.is_in(40500));
+
+        HashSet<int> a_only = a.difference(b, threads);    // b менша, стираємо з копії
+        EXPECT_EQ(a_only.getSize(), 25000);
+        EXPECT_FALSE(a_only.is_in(22000));
+        HashSet<int> b_only = b.difference(a, threads);    // a більша, перевіряємо кожен елемент b
+        EXPECT_EQ(b_only.getSize(), 1000);
+        EXPECT_TRUE(b_only.is_in(40000));
+
+        HashSet<int> either = a.symmetric_difference(b, threads);
+        EXPECT_EQ(either.getSize(), 26000);
+        EXPECT_FALSE(either.is_in(24999));
+
+        EXPECT_TRUE(both.is_subset_of(a, threads));
+        EXPECT_TRUE(both.is_subset_of(b, threads));
+        EXPECT_FALSE(b.is_subset_of(a, threads));
+        EXPECT_FALSE(a.is_subset_of(b, threads));
+        EXPECT_EQ(a.getSize(), 30000); // операнди не змінюються
+    }
+
+    // Переміщена множина лишається порожньою і придатною
+    HashSet<std::string> words;
+    words.add("alpha");
+    HashSet<std::string> moved(std::move(words));
+    EXPECT_TRUE(moved.is_in("alpha"));
+    EXPECT_EQ(words.getSize(), 0);
+    words.add("beta");
+    EXPECT_TRUE(words.is_in("beta"));
+
+    // Присвоєння з переміщенням, без виділення пам'яті для переміщеної множини
+    static_assert(std::is_nothrow_move_constructible<HashSet<std::string>>::value);
+    static_assert(std::is_nothrow_move_assignable<HashSet<std::string>>::value);
+    HashSet<int> a, b, s;
+    for (int i = 0; i < 100; ++i) a.add(i);
+    for (int i = 50; i < 150; ++i) b.add(i);
+    s.add(-1);
+    s = a.intersect(b);
+    EXPECT_EQ(s.getSize(), 50);
+    EXPECT_FALSE(s.is_in(-1));
+    EXPECT_TRUE(s.is_in(75));
+    HashSet<int> t;
+    t = std::move(s);
+    EXPECT_EQ(t.getSize(), 50);
+    EXPECT_EQ(s.getSize(), 0);
+    EXPECT_FALSE(s.is_in(75));
+    EXPECT_FALSE(s.erase(75));
+    s.set_max_load_factor(0.5f);
+    for (int i = 0; i < 1000; ++i) s.add(i);
+    EXPECT_EQ(s.getSize(), 1000);
+    s = std::move(s);
+    EXPECT_EQ(s.getSize(), 1000);
+}
+
+// Тест для фільтра Блума перед пошуком
+TEST(HashSetLargeDataTest, BloomFilter) {
+    HashSet<std::string> set;
+    set.set_bloom_filter(true);
+    ASSERT_TRUE(set.has_bloom_filter());
+    const int dataSize = 20000;
+    for (int i = 0; i < dataSize; ++i) set.add("item_" + std::to_string(i)); // з перехешуванням
+    for (int i = 0; i < dataSize; ++i) {
+        ASSERT_TRUE(set.is_in("item_" + std::to_string(i))); // фільтр не дає хибних відмов
+    }
+    EXPECT_FALSE(set.is_in("missing"));
+
+    // Після багатьох видалень фільтр перебудовується
+    for (int i = 0; i < dataSize; i += 4) set.pop("item_" + std::to_string(i));
+    for (int i = 0; i < dataSize; ++i) {
+        ASSERT_EQ(set.is_in("item_" + std::to_string(i)), i % 4 != 0);
+    }
+    std::vector<std::string> items;
+    for (int i = 0; i < 100; ++i) items.push_back("item_" + std::to_string(i));
+    std::unique_ptr<bool[]> found(new bool[items.size()]);
+    set.contains_many(items.data(), items.size(), found.get());
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(found[i], i % 4 != 0);
+
+    set.set_bloom_filter(false);
+    EXPECT_FALSE(set.has_bloom_filter());
+    EXPECT_TRUE(set.is_in("item_1"));
+
+    // Частка хибних спрацьовувань самого фільтра
+    BlockedBloomFilter filter(10000);
+    for (int i = 0; i < 10000; ++i) filter.insert(DefaultHash<int>()(i));
+    int falsePositives = 0;
+    for (int i = 10000; i < 110000; ++i) falsePositives += filter.may_contain(DefaultHash<int>()(i));
+    EXPECT_LT(falsePositives, 3000); // менше 3%
+}
+
+// Тест для незмінної множини на мінімальному досконалому хеші
+TEST(HashSetLargeDataTest, PerfectHashSet) {
+    const int dataSize = 100000;
+    HashSet<std::string> set;
+    for (int i = 0; i < dataSize; ++i) set.add("item_" + std::to_string(i));
+
+    PerfectHashSet<std::string> frozen(set);
+    EXPECT_EQ(frozen.getSize(), (size_t)dataSize);
+    std::vector<bool> seen(dataSize, false);
+    for (int i = 0; i < dataSize; ++i) {
+        std::string item = "item_" + std::to_string(i);
+        ASSERT_TRUE(frozen.is_in(item));
+        std::size_t index = frozen.index_of(item);
+        ASSERT_LT(index, (size_t)dataSize);
+        ASSERT_FALSE(seen[index]); // кожен елемент має свій індекс
+        seen[index] = true;
+    }
+    EXPECT_FALSE(frozen.is_in("missing"));
+    EXPECT_EQ(frozen.index_of("missing"), (size_t)dataSize);
+    EXPECT_LT(frozen.overhead_size(), (size_t)dataSize); // менше байта на елемент
+
+    std::vector<int> repeated = {1, 2, 3, 2};
+    EXPECT_THROW((PerfectHashSet<int>(repeated)), std::logic_error);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
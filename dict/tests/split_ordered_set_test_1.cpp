@@ -0,0 +1,94 @@
+#include "../set/SplitOrderedSet.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+// Тест для основних операцій в одному потоці
+TEST(SplitOrderedSetTest, SingleThread) {
+    SplitOrderedSet<std::string> set;
+    const int dataSize = 20000;
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_TRUE(set.add("item_" + std::to_string(i)));
+    }
+    EXPECT_FALSE(set.add("item_5")); // елемент уже є
+    ASSERT_EQ(set.getSize(), dataSize);
+    EXPECT_GE(set.getTrueSize() * 2, dataSize / 2); // таблиця росла
+
+    for (int i = 0; i < dataSize; i += 2) {
+        set.pop("item_" + std::to_string(i));
+    }
+    EXPECT_THROW(set.pop("item_0"), std::logic_error);
+    EXPECT_FALSE(set.erase("item_2"));
+    EXPECT_EQ(set.getSize(), dataSize / 2);
+    for (int i = 0; i < dataSize; ++i) {
+        ASSERT_EQ(set.is_in("item_" + std::to_string(i)), i % 2 == 1);
+    }
+}
+
+// Тест для одночасних вставок і видалень з кількох потоків
+TEST(SplitOrderedSetTest, ConcurrentAddAndErase) {
+    SplitOrderedSet<int> set;
+    const int threadsCount = 4;
+    const int perThread = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&set, t]() {
+            // кожен потік має свої ключі, а ключі кратні 3 видаляє одразу
+            for (int i = t * perThread; i < (t + 1) * perThread; ++i) {
+                set.add(i);
+                if (i % 3 == 0) set.erase(i);
+            }
+        });
+    }
+    // Читач працює паралельно з ростом таблиці
+    std::atomic<bool> done(false);
+    std::atomic<bool> failed(false);
+    std::thread reader([&]() {
+        while (!done) {
+            if (set.is_in(-1)) failed = true;
+        }
+    });
+    for (auto& thread : threads) thread.join();
+    done = true;
+    reader.join();
+
+    EXPECT_FALSE(failed);
+    int expected = 0;
+    for (int i = 0; i < threadsCount * perThread; ++i) {
+        ASSERT_EQ(set.is_in(i), i % 3 != 0);
+        if (i % 3 != 0) expected++;
+    }
+    EXPECT_EQ(set.getSize(), expected);
+}
+
+// Тест для конкуренції за ті самі елементи
+TEST(SplitOrderedSetTest, ContendedKeys) {
+    SplitOrderedSet<int> set;
+    std::atomic<int> added(0);
+    std::atomic<int> erased(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < 200; ++round) {
+                for (int i = 0; i < 100; ++i) {
+                    if (set.add(i)) added++;
+                    if (set.erase(i)) erased++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // кожне успішне додавання рівно одне видалення
+    EXPECT_EQ(added.load(), erased.load());
+    EXPECT_EQ(set.getSize(), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
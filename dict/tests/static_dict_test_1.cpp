@@ -0,0 +1,62 @@
+#include "../StaticHashDict.h"
+#include <gtest/gtest.h>
+#include <string>
+
+// Таблиця ключових слів, побудована під час компіляції
+constexpr auto keywords = make_static_dict<int>({
+    {"if", 1}, {"else", 2}, {"while", 3}, {"for", 4}, {"return", 5},
+    {"break", 6}, {"continue", 7}, {"switch", 8}, {"case", 9}, {"default", 10},
+    {"do", 11}, {"goto", 12}, {"struct", 13}, {"union", 14}, {"enum", 15},
+    {"", 16}
+});
+
+// Пошук під час компіляції
+static_assert(keywords["while"] == 3);
+static_assert(keywords[""] == 16);
+static_assert(keywords.is_in("goto"));
+static_assert(!keywords.is_in("class"));
+static_assert(keywords.find("whil") == nullptr);
+static_assert(keywords.getSize() == 16);
+
+// Тест для пошуку під час виконання
+TEST(StaticHashDictTest, RuntimeLookup) {
+    const char* words[] = {"if", "else", "while", "for", "return", "break", "continue", "switch",
+                           "case", "default", "do", "goto", "struct", "union", "enum"};
+    for (int i = 0; i < 15; ++i) {
+        std::string word = words[i]; // рядок, відомий лише під час виконання
+        const int* value = keywords.find(word);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, i + 1);
+    }
+    EXPECT_FALSE(keywords.is_in(std::string("iff")));
+    EXPECT_FALSE(keywords.is_in(std::string("els")));
+    EXPECT_THROW(keywords[std::string("class")], std::logic_error);
+    EXPECT_LE(keywords.getTrueSize(), 2 * keywords.getSize() * 2);
+}
+
+// Словник з одного ключа
+constexpr StaticHashDict<int, 1> single({{"only", 42}});
+static_assert(single["only"] == 42);
+
+// Тест для більшої таблиці з масиву пар
+TEST(StaticHashDictTest, ManyKeys) {
+    static constexpr std::pair<std::string_view, int> items[] = {
+        {"k0", 0}, {"k1", 1}, {"k2", 2}, {"k3", 3}, {"k4", 4}, {"k5", 5}, {"k6", 6}, {"k7", 7},
+        {"k8", 8}, {"k9", 9}, {"k10", 10}, {"k11", 11}, {"k12", 12}, {"k13", 13}, {"k14", 14},
+        {"k15", 15}, {"k16", 16}, {"k17", 17}, {"k18", 18}, {"k19", 19}, {"k20", 20}, {"k21", 21},
+        {"k22", 22}, {"k23", 23}, {"k24", 24}, {"k25", 25}, {"k26", 26}, {"k27", 27}, {"k28", 28},
+        {"k29", 29}, {"k30", 30}, {"k31", 31}, {"k32", 32}, {"k33", 33}, {"k34", 34}, {"k35", 35},
+        {"k36", 36}, {"k37", 37}, {"k38", 38}, {"k39", 39}
+    };
+    constexpr auto dict = make_static_dict(items);
+    static_assert(dict["k37"] == 37);
+    for (int i = 0; i < 40; ++i) {
+        EXPECT_EQ(dict["k" + std::to_string(i)], i);
+    }
+    EXPECT_FALSE(dict.is_in("k40"));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
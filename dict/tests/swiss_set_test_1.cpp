@@ -0,0 +1,113 @@
+#include "../set/SwissSet.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <type_traits>
+
+// Тест для додавання елементів та перевірки наявності у множині
+TEST(SwissSetTest, AddAndIsInTest) {
+    SwissSet<int> set;
+    const int dataSize = 100000;
+
+    for (int i = 0; i < dataSize; ++i) {
+        set.add(i);
+    }
+    set.add(0); // повторний елемент ігнорується
+    ASSERT_EQ(set.getSize(), dataSize);
+
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_TRUE(set.is_in(i));
+    }
+    // Перевірка промахів
+    for (int i = dataSize; i < 2 * dataSize; ++i) {
+        EXPECT_FALSE(set.is_in(i));
+    }
+}
+
+// Тест для рядкових ключів
+TEST(SwissSetTest, StringKeys) {
+    SwissSet<std::string> set;
+    const int dataSize = 20000;
+
+    for (int i = 0; i < dataSize; ++i) {
+        set.add("key_" + std::to_string(i));
+    }
+    ASSERT_EQ(set.getSize(), dataSize);
+
+    for (int i = 0; i < dataSize; ++i) {
+        EXPECT_TRUE(set.is_in("key_" + std::to_string(i)));
+    }
+    EXPECT_FALSE(set.is_in("absent"));
+}
+
+// Тест для видалення: надгробки не повинні ламати пошук і мають прибиратися при перебудові
+TEST(SwissSetTest, PopAndReuse) {
+    SwissSet<int> set;
+    const int dataSize = 50000;
+
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < dataSize; ++i) {
+            set.add(i + round * dataSize);
+        }
+        for (int i = 0; i < dataSize; i += 2) {
+            set.pop(i + round * dataSize);
+        }
+    }
+    ASSERT_EQ(set.getSize(), 4 * dataSize / 2);
+
+    for (int i = 0; i < 4 * dataSize; ++i) {
+        EXPECT_EQ(set.is_in(i), i % 2 == 1);
+    }
+    EXPECT_THROW(set.pop(0), std::logic_error);
+}
+
+// Тест для того, що SIMD-група і переносна 64-бітна група знаходять ті самі слоти
+TEST(SwissSetTest, PortableGroupMatchesSimd) {
+    std::mt19937 random(42);
+    const int8_t special[] = {SWISS_EMPTY, SWISS_DELETED};
+    int8_t ctrl[SwissGroup::WIDTH];
+
+    for (int round = 0; round < 20000; ++round) {
+        // мало різних тегів, щоб збігів і сусідніх тегів h2 ^ 1 було багато
+        for (int8_t& c : ctrl) {
+            int r = random() % 8;
+            c = r < 2 ? special[r] : static_cast<int8_t>(random() % 4 + (round % 32) * 4);
+        }
+        int8_t h2 = ctrl[random() % SwissGroup::WIDTH];
+        if (h2 < 0) h2 = static_cast<int8_t>(random() % 128);
+
+        SwissGroup group(ctrl);
+        for (int offset = 0; offset < SwissGroup::WIDTH; offset += SwissGroupPortable::WIDTH) {
+            SwissGroupPortable portable(ctrl + offset);
+            uint64_t found = portable.match(h2);
+            uint64_t empty = portable.match_empty();
+            uint64_t free = portable.match_empty_or_deleted();
+            uint64_t first_match = 0;
+            for (int i = 0; i < SwissGroupPortable::WIDTH; ++i) {
+                uint64_t bit = 1ULL << (i * SwissGroupPortable::STRIDE + 7);
+                uint64_t simd_bit = 1ULL << ((offset + i) * SwissGroup::STRIDE + SwissGroup::STRIDE - 1);
+                bool is_match = ctrl[offset + i] == h2;
+                if (!std::is_same_v<SwissGroup, SwissGroupPortable>) {
+                    ASSERT_EQ((group.match(h2) & simd_bit) != 0, is_match); // SIMD порівнює точно
+                }
+                ASSERT_EQ((empty & bit) != 0, (group.match_empty() & simd_bit) != 0);
+                ASSERT_EQ((free & bit) != 0, (group.match_empty_or_deleted() & simd_bit) != 0);
+                if (is_match) {
+                    ASSERT_NE(found & bit, 0u); // справжній збіг не пропускається
+                    if (first_match == 0) first_match = bit;
+                } else if (found & bit) {
+                    // хибний збіг буває лише вище справжнього
+                    ASSERT_NE(first_match, 0u);
+                }
+            }
+            if (found != 0) {
+                EXPECT_EQ(SwissGroupPortable::lowest(found), SwissGroupPortable::lowest(first_match));
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}